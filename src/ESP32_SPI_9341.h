@@ -20,6 +20,13 @@
 #define TOUCH_CS 33
 #define TOUCH_IRQ 36
 
+#ifndef ARDUINO
+// Host builds draw into the framebuffer device from src/native/shim
+class LGFX : public lgfx::LGFX_Device {
+   public:
+    LGFX(void) : lgfx::LGFX_Device(240, 320) {}
+};
+#else
 class LGFX : public lgfx::LGFX_Device {
     lgfx::Panel_ILI9341 _panel_instance;
     lgfx::Bus_SPI _bus_instance;
@@ -114,5 +121,6 @@ class LGFX : public lgfx::LGFX_Device {
         setPanel(&_panel_instance);  // 使用するパネルをセットします。
     }
 };
+#endif
 
 #endif /* F455A1B7_80E2_4672_959C_840DEE6F1F26 */
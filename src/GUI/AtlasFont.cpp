@@ -0,0 +1,134 @@
+#include "AtlasFont.hpp"
+
+#include <algorithm>
+
+// 565 blend of two colors, alpha 0..15
+static uint16_t blend565(uint16_t fg, uint16_t bg, uint8_t alpha) {
+    uint32_t rb = (((fg & 0xF81F) * alpha) + ((bg & 0xF81F) * (15 - alpha))) / 15;
+    uint32_t g = (((fg & 0x07E0) * alpha) + ((bg & 0x07E0) * (15 - alpha))) / 15;
+    return (rb & 0xF81F) | (g & 0x07E0);
+}
+
+const AtlasGlyph* AtlasFont::findGlyph(const AtlasFontData& font, uint16_t codepoint) {
+    int low = 0;
+    int high = font.glyphCount - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        uint16_t value = font.glyphs[mid].codepoint;
+        if (value == codepoint) {
+            return &font.glyphs[mid];
+        }
+        if (value < codepoint) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return nullptr;
+}
+
+int AtlasFont::kerning(const AtlasFontData& font, uint16_t left, uint16_t right) {
+    uint32_t key = ((uint32_t)left << 16) | right;
+    int low = 0;
+    int high = font.kernCount - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        uint32_t value = ((uint32_t)font.kerns[mid].left << 16) | font.kerns[mid].right;
+        if (value == key) {
+            return font.kerns[mid].adjust;
+        }
+        if (value < key) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return 0;
+}
+
+// Every coverage level maps to one of 16 precomputed shades. Palette targets
+// (page snapshots) hold indices, not colors, so edges are thresholded there.
+static void makeShades(lgfx::LovyanGFX& gfx, uint16_t foreground, uint16_t background, uint16_t* shades) {
+    bool indexed = gfx.hasPalette();
+    for (uint8_t alpha = 0; alpha < 16; alpha++) {
+        shades[alpha] = indexed ? (alpha >= 8 ? foreground : background) : blend565(foreground, background, alpha);
+    }
+}
+
+static Rectangle clipOf(lgfx::LovyanGFX& gfx) {
+    int32_t x, y, w, h;
+    gfx.getClipRect(&x, &y, &w, &h);
+    return Rectangle(x, y, w, h);
+}
+
+void AtlasFont::drawPlaced(lgfx::LovyanGFX& gfx, const AtlasFontData& font, const PlacedGlyph* glyphs, size_t count, int x, int y,
+                           uint16_t foreground, uint16_t background) {
+    uint16_t shades[16];
+    makeShades(gfx, foreground, background, shades);
+    Rectangle clip = clipOf(gfx);
+
+    gfx.startWrite();
+    for (size_t i = 0; i < count; i++) {
+        drawGlyph(gfx, font, *glyphs[i].glyph, x + glyphs[i].x, y + glyphs[i].glyph->yOffset, shades, clip);
+    }
+    gfx.endWrite();
+}
+
+void AtlasFont::drawGlyph(lgfx::LovyanGFX& gfx, const AtlasFontData& font, const AtlasGlyph& glyph, int x, int y, const uint16_t* shades,
+                          const Rectangle& clip) {
+    if (glyph.width == 0 || glyph.height == 0 || glyph.width > ATLAS_MAX_GLYPH_WIDTH) {
+        return;
+    }
+
+    // setAddrWindow ignores the clip rect, so the window is cut to it here. Runs
+    // cross rows, so rows above the cut are still decoded, just not written.
+    int x0 = std::max(x, clip.origin.x);
+    int y0 = std::max(y, clip.origin.y);
+    int x1 = std::min(x + glyph.width, clip.origin.x + clip.w);
+    int y1 = std::min(y + glyph.height, clip.origin.y + clip.h);
+    if (x1 <= x0 || y1 <= y0) {
+        return;
+    }
+
+    const uint8_t* stream = font.bitmaps + glyph.offset;
+    uint16_t row[ATLAS_MAX_GLYPH_WIDTH];
+    int column = 0;
+
+    // Decoder state carried across rows
+    uint8_t runLength = 0;
+    uint8_t runKind = 0;
+    bool highNibble = true;
+
+    gfx.setAddrWindow(x0, y0, x1 - x0, y1 - y0);
+    for (int line = 0; line < y1 - y; line++) {
+        for (column = 0; column < glyph.width; column++) {
+            if (runLength == 0) {
+                uint8_t code = *stream++;
+                runKind = code & 0xC0;
+                runLength = (code & 0x3F) + 1;
+                highNibble = true;
+            }
+
+            uint8_t alpha;
+            if (runKind == 0x00) {
+                alpha = 0;
+            } else if (runKind == 0x40) {
+                alpha = 15;
+            } else {
+                alpha = highNibble ? (*stream >> 4) : (*stream++ & 0x0F);
+                highNibble = !highNibble;
+            }
+            runLength--;
+
+            // An odd literal run leaves a half-used byte behind
+            if (runLength == 0 && runKind == 0x80 && !highNibble) {
+                stream++;
+            }
+
+            row[column] = shades[alpha];
+        }
+        if (y + line >= y0) {
+            gfx.writePixels(row + (x0 - x), x1 - x0);
+        }
+    }
+}
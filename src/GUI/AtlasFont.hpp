@@ -0,0 +1,64 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ESP32_SPI_9341.h"
+#include "../utils.hpp"
+
+// Anti-aliased fonts produced offline by tools/fontconv.py (`pio run -t fonts`).
+// Glyph coverage is 4 bits per pixel, run-length coded:
+//   0x00-0x3F  (n & 0x3F) + 1 transparent pixels
+//   0x40-0x7F  (n & 0x3F) + 1 fully covered pixels
+//   0x80-0xBF  (n & 0x3F) + 1 literal pixels follow, two per byte, high nibble first
+// Runs continue across rows of the same glyph.
+
+struct AtlasGlyph {
+    uint16_t codepoint;
+    uint8_t width;
+    uint8_t height;
+    int8_t xOffset;   // From the pen position to the bitmap's left edge
+    int8_t yOffset;   // From the top of the line to the bitmap's top edge
+    uint8_t advance;
+    uint32_t offset;  // Into AtlasFontData::bitmaps
+};
+
+struct AtlasKern {
+    uint16_t left;
+    uint16_t right;
+    int8_t adjust;
+};
+
+struct AtlasFontData {
+    uint8_t lineHeight;
+    uint8_t ascent;
+    uint16_t glyphCount;
+    const AtlasGlyph* glyphs;  // Sorted by codepoint
+    uint16_t kernCount;
+    const AtlasKern* kerns;    // Sorted by (left, right)
+    const uint8_t* bitmaps;
+};
+
+// A glyph placed by text shaping (ShapedRun), x is the bitmap's left edge from the run's start
+struct PlacedGlyph {
+    const AtlasGlyph* glyph;
+    int16_t x;
+};
+
+#define ATLAS_MAX_GLYPH_WIDTH 64
+
+class AtlasFont {
+   public:
+    static const AtlasGlyph* findGlyph(const AtlasFontData& font, uint16_t codepoint);
+    static int kerning(const AtlasFontData& font, uint16_t left, uint16_t right);
+
+    // Draws glyphs looked up and positioned by text shaping (ShapedRun). Each one is
+    // blended against a solid background and written as one window, cut to the
+    // target's clip rect. Pixels between glyphs are left untouched, the caller
+    // fills the background.
+    static void drawPlaced(lgfx::LovyanGFX& gfx, const AtlasFontData& font, const PlacedGlyph* glyphs, size_t count, int x, int y,
+                           uint16_t foreground, uint16_t background);
+
+   private:
+    static void drawGlyph(lgfx::LovyanGFX& gfx, const AtlasFontData& font, const AtlasGlyph& glyph, int x, int y, const uint16_t* shades,
+                          const Rectangle& clip);
+};
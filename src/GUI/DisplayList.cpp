@@ -0,0 +1,183 @@
+#include "DisplayList.hpp"
+
+#include "AtlasFont.hpp"
+#include "PaletteBuffer.hpp"
+#include "../diag/MemoryTags.hpp"
+
+static DrawOpStats s_opStats[static_cast<uint8_t>(DrawOp::Count)];
+static uint32_t s_recordCount = 0;
+
+static const char* const OP_NAMES[] = {"fill", "frame", "text", "atlas-text", "image"};
+
+static uint16_t resolve(ColorRole role, const Theme& theme, const Style& style) {
+    switch (role) {
+        case ColorRole::Screen:
+            return theme.screen;
+        case ColorRole::Background:
+            return style.background;
+        case ColorRole::Foreground:
+            return style.foreground;
+        case ColorRole::Border:
+            return style.border;
+    }
+    return style.foreground;
+}
+
+DisplayList::DisplayList() : m_valid(false), m_width(0), m_height(0), m_font(nullptr), m_fontHeight(0) {
+}
+
+DisplayList::~DisplayList() {
+    memResize(MemTag::Components, m_commands.capacity() * sizeof(DrawCommand), 0);
+}
+
+bool DisplayList::isStale(int width, int height, const AtlasFontData* font, int fontHeight) const {
+    return !m_valid || width != m_width || height != m_height || font != m_font || fontHeight != m_fontHeight;
+}
+
+void DisplayList::invalidate() {
+    m_valid = false;
+}
+
+void DisplayList::begin(int width, int height, const AtlasFontData* font, int fontHeight) {
+    m_commands.clear();  // Keeps the capacity, lists settle at their size
+    m_valid = true;
+    m_width = width;
+    m_height = height;
+    m_font = font;
+    m_fontHeight = fontHeight;
+    s_recordCount++;
+}
+
+void DisplayList::add(const DrawCommand& command) {
+    size_t capacity = m_commands.capacity();
+    m_commands.push_back(command);
+    memTrackGrowth(MemTag::Components, m_commands, capacity);
+}
+
+void DisplayList::fillRect(int x, int y, int w, int h, ColorRole color) {
+    add({DrawOp::FillRect, color, color, 0, (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h, nullptr, nullptr, nullptr});
+}
+
+void DisplayList::frame(int x, int y, int w, int h) {
+    add({DrawOp::Frame, ColorRole::Border, ColorRole::Background, 0, (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h, nullptr, nullptr, nullptr});
+}
+
+void DisplayList::text(int x, int y, int w, int h, const char* text, ColorRole color, ColorRole background, uint8_t textSize) {
+    add({DrawOp::Text, color, background, textSize, (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h, text, nullptr, nullptr});
+}
+
+void DisplayList::atlasText(int x, int y, int w, int h, const ShapedRun* run, ColorRole color, ColorRole background) {
+    add({DrawOp::AtlasText, color, background, 0, (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h, nullptr, run, nullptr});
+}
+
+void DisplayList::image(int x, int y, int w, int h, const PaletteBuffer* image, ColorRole dark, ColorRole light) {
+    add({DrawOp::Image, light, dark, 0, (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h, nullptr, nullptr, image});
+}
+
+// Palette targets (page snapshots, mirror strips) hold theme indices, not
+// colors, so images are thresholded there like anti-aliased text edges
+static void pushImage(lgfx::LovyanGFX& lcd, const PaletteBuffer& image, const Rectangle& area, const Rectangle& clip, uint16_t dark,
+                      uint16_t light) {
+    // setAddrWindow ignores the clip rect, so the source is cut to it here
+    int x0 = std::max(area.origin.x, clip.origin.x);
+    int y0 = std::max(area.origin.y, clip.origin.y);
+    int x1 = std::min(area.origin.x + area.w, clip.origin.x + clip.w);
+    int y1 = std::min(area.origin.y + area.h, clip.origin.y + clip.h);
+    if (x1 <= x0 || y1 <= y0) {
+        return;
+    }
+    Rectangle source(x0 - area.origin.x, y0 - area.origin.y, x1 - x0, y1 - y0);
+
+    if (!lcd.hasPalette()) {
+        image.pushRegion(lcd, x0, y0, source);
+        return;
+    }
+    uint16_t twoTone[256];
+    for (uint16_t i = 0; i < 256; i++) {
+        uint16_t color = image.colorOf(i);
+        uint32_t luma = (color >> 11) * 2 * 299 + ((color >> 5) & 0x3F) * 587 + (color & 0x1F) * 2 * 114;  // 0..63000
+        twoTone[i] = luma >= 31500 ? light : dark;
+    }
+    image.pushRegion(lcd, x0, y0, source, twoTone);
+}
+
+void DisplayList::replay(lgfx::LovyanGFX& lcd, const Theme& theme, const Style& style, Point origin, const Rectangle& clip) const {
+    for (const auto& command : m_commands) {
+        DrawOpStats& stats = s_opStats[static_cast<uint8_t>(command.op)];
+        Rectangle area(origin.x + command.x, origin.y + command.y, command.w, command.h);
+        if (!area.intersects(clip)) {
+            stats.culled++;
+            continue;
+        }
+
+        uint32_t startUs = micros();
+        uint16_t color = resolve(command.color, theme, style);
+        uint16_t background = resolve(command.background, theme, style);
+        switch (command.op) {
+            case DrawOp::FillRect:
+                lcd.fillRect(area.origin.x, area.origin.y, area.w, area.h, color);
+                break;
+            case DrawOp::Frame:
+                if (color != background) {
+                    lcd.drawRect(area.origin.x, area.origin.y, area.w, area.h, color);
+                }
+                break;
+            case DrawOp::Text: {
+                float textSize = lcd.getTextSizeX();
+                if (command.textSize != 0) {
+                    lcd.setTextSize(command.textSize);
+                }
+                lcd.setTextColor(color, background);
+                lcd.setCursor(area.origin.x, area.origin.y);
+                lcd.print(command.text);
+                if (command.textSize != 0) {
+                    lcd.setTextSize(textSize);
+                }
+                break;
+            }
+            case DrawOp::AtlasText:
+                if (theme.font != nullptr) {
+                    command.run->draw(lcd, *theme.font, area.origin.x, area.origin.y, color, background);
+                }
+                break;
+            case DrawOp::Image:
+                if (command.image != nullptr) {
+                    pushImage(lcd, *command.image, area, clip, background, color);
+                }
+                break;
+            case DrawOp::Count:
+                break;
+        }
+        stats.replayed++;
+        stats.pixels += area.w * area.h;
+        stats.us += micros() - startUs;
+    }
+}
+
+size_t DisplayList::size() const {
+    return m_commands.size();
+}
+
+const DrawOpStats& drawOpStats(DrawOp op) {
+    return s_opStats[static_cast<uint8_t>(op)];
+}
+
+uint32_t displayListRecordCount() {
+    return s_recordCount;
+}
+
+void resetDrawOpStats() {
+    for (auto& stats : s_opStats) {
+        stats = {0, 0, 0, 0};
+    }
+    s_recordCount = 0;
+}
+
+void reportDrawOpStats(Print& out) {
+    out.printf("[draw] %u lists recorded, %u labels shaped since boot\n", s_recordCount, shapedRunCount());
+    for (uint8_t op = 0; op < static_cast<uint8_t>(DrawOp::Count); op++) {
+        const DrawOpStats& stats = s_opStats[op];
+        out.printf("[draw] %-10s %6u replayed %6u culled %9u px %8u us\n", OP_NAMES[op], stats.replayed, stats.culled, stats.pixels,
+                   stats.us);
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+
+#include <vector>
+
+#include "Arduino.h"
+#include "ESP32_SPI_9341.h"
+#include "../utils.hpp"
+#include "ShapedText.hpp"
+#include "theme.hpp"
+
+class PaletteBuffer;
+
+// Retained drawing. A component records compact commands once and the
+// compositor replays them whenever the component is dirty, clipped to the
+// damaged region. Positions are relative to the component's top left corner
+// and colors name a role in the theme, so moving the component, pressing it
+// or switching themes replays the same list. Only a change to what is drawn
+// (text, size, fonts) records it again.
+
+enum class DrawOp : uint8_t {
+    FillRect,   // Solid rectangle
+    Frame,      // One pixel outline, skipped when the border matches the background
+    Text,       // Built-in font
+    AtlasText,  // Anti-aliased theme font, glyphs placed by a ShapedRun
+    Image,      // Palette buffer copied 1:1, two-tone on palette targets
+    Count
+};
+
+enum class ColorRole : uint8_t {
+    Screen,  // Theme::screen
+    Background,
+    Foreground,
+    Border
+};
+
+struct DrawCommand {
+    DrawOp op;
+    ColorRole color;
+    ColorRole background;  // Text only
+    uint8_t textSize;      // Text only, 0 keeps the target's size
+    int16_t x, y, w, h;    // Text commands keep their measured extent for culling
+    const char* text;      // Owned by the component, valid until it records again
+    const ShapedRun* run;  // AtlasText only, likewise
+    const PaletteBuffer* image;  // Image only, likewise
+};
+
+// Replay cost per command type since the last reset
+struct DrawOpStats {
+    uint32_t replayed;
+    uint32_t culled;  // Entirely outside the damaged region
+    uint32_t pixels;  // Area of the replayed commands
+    uint32_t us;
+};
+
+class DisplayList {
+   public:
+    DisplayList();
+    ~DisplayList();
+
+    // Whether the list must be recorded again for this size and these fonts
+    bool isStale(int width, int height, const AtlasFontData* font, int fontHeight) const;
+    void invalidate();
+
+    void begin(int width, int height, const AtlasFontData* font, int fontHeight);
+    void fillRect(int x, int y, int w, int h, ColorRole color);
+    void frame(int x, int y, int w, int h);
+    void text(int x, int y, int w, int h, const char* text, ColorRole color, ColorRole background, uint8_t textSize = 0);
+    void atlasText(int x, int y, int w, int h, const ShapedRun* run, ColorRole color, ColorRole background);
+    void image(int x, int y, int w, int h, const PaletteBuffer* image, ColorRole dark, ColorRole light);
+
+    // Draws the commands at origin with the style's colors, skipping those outside clip (screen coordinates)
+    void replay(lgfx::LovyanGFX& lcd, const Theme& theme, const Style& style, Point origin, const Rectangle& clip) const;
+
+    size_t size() const;
+
+   private:
+    std::vector<DrawCommand> m_commands;
+    bool m_valid;
+    int16_t m_width;
+    int16_t m_height;
+    const AtlasFontData* m_font;
+    int16_t m_fontHeight;
+
+    void add(const DrawCommand& command);
+};
+
+const DrawOpStats& drawOpStats(DrawOp op);
+uint32_t displayListRecordCount();
+void resetDrawOpStats();
+void reportDrawOpStats(Print& out);
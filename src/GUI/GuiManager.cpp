@@ -2,11 +2,19 @@
 #include <algorithm>
 
 GuiManager::GuiManager(LGFX& lcd)
-    : m_lcd(lcd), m_textSize(DEFAULT_TEXT_SIZE), m_textColor(TFT_WHITE) {
+    : m_lcd(lcd), m_pressed(nullptr), m_textSize(DEFAULT_TEXT_SIZE), m_textColor(TFT_WHITE), m_theme(&DARK_THEME), m_inbox(nullptr), m_outbox(nullptr), m_suspendRequested(false), m_suspended(false), m_suppressTouch(false), m_lastActivityMs(0), m_lastWorkMs(0), m_recorder(nullptr), m_watchdog(nullptr) {
+    m_currentPage = createPage("main");
+    setComponentAnimator(&m_animator);
 }
 
 GuiManager::~GuiManager() {
-    clearComponents();
+    if (componentAnimator() == &m_animator) {
+        setComponentAnimator(nullptr);
+    }
+    for (auto* page : m_pages) {
+        delete page;
+    }
+    m_pages.clear();
 }
 
 void GuiManager::init() {
@@ -20,46 +28,164 @@ void GuiManager::init() {
         std::uint16_t calData[8];  // Standard calibration data array size
         if (loadTouchCalibration(calData)) {
             m_lcd.setTouchCalibrate(calData);
-            Serial.println("Touch calibration loaded from storage");
+            LOG_I("Touch calibration loaded from storage");
         } else {
-            Serial.println("Failed to load touch calibration, performing new calibration");
+            LOG_W("Failed to load touch calibration, performing new calibration");
             performTouchCalibration();
         }
     } else {
         // No saved calibration found, perform calibration
-        Serial.println("No saved touch calibration found, performing calibration");
+        LOG_I("No saved touch calibration found, performing calibration");
         performTouchCalibration();
     }
 }
 
 void GuiManager::update() {
+    FrameWatchdog* watchdog = m_watchdog;
+    if (watchdog != nullptr) {
+        watchdog->beginFrame();
+    }
+    drainMessages();
+
+    // The model keeps following the host while blanked, drawing waits for wake up
+    applySuspend();
+    if (watchdog != nullptr) {
+        watchdog->mark(FramePhase::Messages);
+    }
+    if (m_suspended) {
+        if (watchdog != nullptr) {
+            watchdog->endFrame();
+        }
+        return;
+    }
+
+    m_animator.update(millis());
+    if (watchdog != nullptr) {
+        watchdog->mark(FramePhase::Animation);
+    }
     drawComponents();
+    if (watchdog != nullptr) {
+        watchdog->mark(FramePhase::Draw);
+    }
     handleComponentTouch();
+    if (watchdog != nullptr) {
+        watchdog->mark(FramePhase::TouchDispatch);
+        watchdog->endFrame();
+    }
 }
 
 void GuiManager::clear() {
-    m_lcd.clear();
+    m_lcd.fillScreen(m_theme->screen);
+    reportDamage(screenRect());
     markAllComponentsDirty();  // Components need to be redrawn after clearing
 }
 
-void GuiManager::addComponent(Component* component) {
-    if (component != nullptr) {
-        m_components.push_back(component);
+Page* GuiManager::createPage(const char* name) {
+    Page* page = new Page(name);
+    m_pages.push_back(page);
+    return page;
+}
+
+void GuiManager::showPage(Page* page) {
+    if (page == nullptr || page == m_currentPage) {
+        return;
+    }
+
+    // Keep an image of the page we leave so coming back to it is instant
+    releasePress();
+    cacheSnapshot(m_currentPage);
+    m_currentPage = page;
+
+    if (page->hasSnapshot()) {
+        // Components that changed while hidden are still dirty and repaint on top
+        page->pushSnapshot(m_lcd);
+        page->dropSnapshot();
+        reportDamage(screenRect());
+        m_snapshotOrder.erase(std::find(m_snapshotOrder.begin(), m_snapshotOrder.end(), page));
+    } else {
+        m_lcd.fillScreen(m_theme->screen);
+        reportDamage(screenRect());
+        markAllComponentsDirty();
+    }
+}
+
+Page* GuiManager::getCurrentPage() const {
+    return m_currentPage;
+}
+
+void GuiManager::cacheSnapshot(Page* page) {
+    auto it = std::find(m_snapshotOrder.begin(), m_snapshotOrder.end(), page);
+    if (it != m_snapshotOrder.end()) {
+        m_snapshotOrder.erase(it);
+    }
+
+    // Evict the least recently left pages first to make room
+    while (!m_snapshotOrder.empty() && m_snapshotOrder.size() >= MAX_CACHED_PAGES) {
+        m_snapshotOrder.front()->dropSnapshot();
+        m_snapshotOrder.erase(m_snapshotOrder.begin());
+    }
+
+    if (page->captureSnapshot(*m_theme, m_lcd.width(), m_lcd.height(), m_textSize)) {
+        m_snapshotOrder.push_back(page);
+    }
+}
+
+bool GuiManager::renderRegion(PaletteBuffer& strip, const Rectangle& region) {
+    std::vector<Component*>& list = components();
+    for (size_t i = 0; i < list.size(); i++) {
+        Component* component = list[i];
+        if (component != nullptr && (component->needsRedraw || component->childrenDirty) && !isCulled(list, i, region)) {
+            return false;
+        }
+    }
+
+    // Same steps as a page snapshot, restricted to the region
+    lgfx::LovyanGFX& canvas = strip.getCanvas();
+    strip.bindTheme(*m_theme);
+    canvas.setTextSize(m_textSize);
+    canvas.setClipRect(0, 0, region.w, region.h);
+    strip.clear();
+    for (size_t i = 0; i < list.size(); i++) {
+        if (list[i] != nullptr && !isCulled(list, i, region)) {
+            strip.renderComponent(*list[i], region.origin.x, region.origin.y);
+        }
+    }
+    canvas.clearClipRect();
+    return true;
+}
+
+std::vector<Component*>& GuiManager::components() {
+    return m_currentPage->getComponents();
+}
+
+Rectangle GuiManager::screenRect() const {
+    return Rectangle(0, 0, m_lcd.width(), m_lcd.height());
+}
+
+void GuiManager::releasePress() {
+    if (m_pressed != nullptr) {
+        m_pressed->touch(false, {0, 0});
+        m_pressed = nullptr;
     }
 }
 
+void GuiManager::addComponent(Component* component) {
+    m_currentPage->addComponent(component);
+}
+
 void GuiManager::removeComponent(Component* component) {
-    auto it = std::find(m_components.begin(), m_components.end(), component);
-    if (it != m_components.end()) {
-        m_components.erase(it);
+    if (component == m_pressed) {
+        m_pressed = nullptr;
+    }
+    if (m_currentPage->removeComponent(component)) {
+        component->cancelAnimations();
     }
 }
 
 void GuiManager::clearComponents() {
-    for (auto* component : m_components) {
-        delete component;
-    }
-    m_components.clear();
+    // Deleted components, their children included, cancel their own animations
+    m_pressed = nullptr;
+    m_currentPage->clearComponents();
 }
 
 Button* GuiManager::createButton(int x, int y, int width, int height, const String& text) {
@@ -95,18 +221,18 @@ void GuiManager::performTouchCalibration() {
 
     // Save the calibration data to preferences
     if (saveTouchCalibration(calData)) {
-        Serial.println("Touch calibration saved to storage");
+        LOG_I("Touch calibration saved to storage");
     } else {
-        Serial.println("Failed to save touch calibration");
+        LOG_E("Failed to save touch calibration");
     }
 
-    m_lcd.clear();
+    m_lcd.fillScreen(m_theme->screen);
     m_lcd.setTextSize(m_textSize);
 }
 
 bool GuiManager::saveTouchCalibration(std::uint16_t* calData) {
     if (calData == nullptr) {
-        Serial.println("Error: Invalid calibration data");
+        LOG_E("Invalid calibration data");
         return false;
     }
 
@@ -121,14 +247,10 @@ bool GuiManager::saveTouchCalibration(std::uint16_t* calData) {
         m_preferences.putBool("cal_valid", true);
 
         // Log the calibration values for debugging
-        Serial.print("Saved calibration data: ");
-        for (int i = 0; i < 8; i++) {
-            Serial.print(calData[i]);
-            if (i < 7) Serial.print(", ");
-        }
-        Serial.println();
+        LOG_D("Saved calibration data: %u, %u, %u, %u, %u, %u, %u, %u", calData[0], calData[1], calData[2], calData[3], calData[4],
+              calData[5], calData[6], calData[7]);
     } else {
-        Serial.println("Error: Failed to save calibration data to preferences");
+        LOG_E("Failed to save calibration data to preferences");
     }
 
     m_preferences.end();
@@ -137,7 +259,7 @@ bool GuiManager::saveTouchCalibration(std::uint16_t* calData) {
 
 bool GuiManager::loadTouchCalibration(std::uint16_t* calData) {
     if (calData == nullptr) {
-        Serial.println("Error: Invalid calibration data buffer");
+        LOG_E("Invalid calibration data buffer");
         return false;
     }
 
@@ -156,14 +278,10 @@ bool GuiManager::loadTouchCalibration(std::uint16_t* calData) {
 
     if (success) {
         // Log the loaded calibration values for debugging
-        Serial.print("Loaded calibration data: ");
-        for (int i = 0; i < 8; i++) {
-            Serial.print(calData[i]);
-            if (i < 7) Serial.print(", ");
-        }
-        Serial.println();
+        LOG_D("Loaded calibration data: %u, %u, %u, %u, %u, %u, %u, %u", calData[0], calData[1], calData[2], calData[3], calData[4],
+              calData[5], calData[6], calData[7]);
     } else {
-        Serial.println("Error: Failed to load calibration data from preferences");
+        LOG_E("Failed to load calibration data from preferences");
     }
 
     m_preferences.end();
@@ -181,7 +299,7 @@ void GuiManager::clearTouchCalibration() {
     m_preferences.begin("touch_cal", false);
     m_preferences.clear();
     m_preferences.end();
-    Serial.println("Touch calibration data cleared");
+    LOG_I("Touch calibration data cleared");
 }
 
 bool GuiManager::processTouchEvents() {
@@ -212,9 +330,129 @@ void GuiManager::println(const String& text) {
 
 void GuiManager::fillScreen(uint16_t color) {
     m_lcd.fillScreen(color);
+    reportDamage(screenRect());
     markAllComponentsDirty();  // Components need to be redrawn after filling screen
 }
 
+void GuiManager::setTheme(const Theme& theme) {
+    if (&theme == m_theme) {
+        return;
+    }
+
+    const Theme* previous = m_theme;
+    m_theme = &theme;
+
+    // Cached snapshots were rendered with the old colors
+    for (auto* page : m_snapshotOrder) {
+        page->dropSnapshot();
+    }
+    m_snapshotOrder.clear();
+
+    // A new screen color means everything behind the components changes, a new font every label
+    if (previous->screen != theme.screen || previous->font != theme.font) {
+        fillScreen(theme.screen);
+        return;
+    }
+
+    // Otherwise only components whose style record actually differs need a redraw
+    for (auto* component : components()) {
+        if (component != nullptr) {
+            component->invalidateStyles(*previous, theme);
+        }
+    }
+}
+
+const Theme& GuiManager::getTheme() const {
+    return *m_theme;
+}
+
+Animator& GuiManager::getAnimator() {
+    return m_animator;
+}
+
+bool GuiManager::isAnimating() const {
+    return m_animator.isActive();
+}
+
+uint32_t GuiManager::getFrameDelay() const {
+    if (m_suspended) {
+        return SUSPENDED_FRAME_MS;
+    }
+    return isAnimating() ? ANIMATION_FRAME_MS : IDLE_FRAME_MS;
+}
+
+void GuiManager::setSuspended(bool suspended) {
+    m_suspendRequested.store(suspended);
+}
+
+bool GuiManager::isSuspended() const {
+    return m_suspended;
+}
+
+uint32_t GuiManager::getLastActivityMs() const {
+    return m_lastActivityMs.load();
+}
+
+bool GuiManager::isBusy() const {
+    if (m_suspended) {
+        return false;
+    }
+    uint32_t now = millis();
+    return isAnimating() || now - m_lastActivityMs.load() < BUSY_HOLD_MS || now - m_lastWorkMs < BUSY_HOLD_MS;
+}
+
+void GuiManager::applySuspend() {
+    bool requested = m_suspendRequested.load();
+    if (requested == m_suspended) {
+        return;
+    }
+
+    // Panel commands go over the SPI bus, so they are only issued from the UI task
+    m_suspended = requested;
+    if (requested) {
+        m_lcd.sleep();
+    } else {
+        m_lcd.wakeup();
+        m_suppressTouch = true;  // The touch that woke us should not press anything
+        m_lastActivityMs.store(millis());
+    }
+}
+
+void GuiManager::setMessageQueues(InboxQueue* inbox, OutboxQueue* outbox) {
+    m_inbox = inbox;
+    m_outbox = outbox;
+}
+
+bool GuiManager::postEvent(const MixerMessage& message) {
+    return m_outbox != nullptr && m_outbox->push(message);
+}
+
+void GuiManager::setTraceRecorder(TraceRecorder* recorder) {
+    m_recorder = recorder;
+}
+
+void GuiManager::setFrameWatchdog(FrameWatchdog* watchdog) {
+    m_watchdog = watchdog;
+}
+
+void GuiManager::drainMessages() {
+    if (m_inbox == nullptr) {
+        return;
+    }
+
+    // Anything beyond the batch waits for the next frame
+    MixerMessage message;
+    for (int i = 0; i < MAX_MESSAGES_PER_FRAME && m_inbox->pop(message); i++) {
+        if (m_recorder != nullptr) {
+            m_recorder->recordMessage(message, millis());
+        }
+        if (onMessage) {
+            onMessage(message);
+        }
+        m_lastWorkMs = millis();
+    }
+}
+
 int GuiManager::getWidth() const {
     return m_lcd.width();
 }
@@ -224,15 +462,17 @@ int GuiManager::getHeight() const {
 }
 
 void GuiManager::drawComponents() {
-    for (auto* component : m_components) {
-        if (component != nullptr && component->needsRedraw) {
-            component->draw(m_lcd);
-        }
+    bool drewAny = drawComponentList(components(), m_lcd, *m_theme, {0, 0}, screenRect());
+
+    // Components set their own text colors; restore ours for direct print calls
+    if (drewAny) {
+        m_lcd.setTextColor(m_textColor);
+        m_lastWorkMs = millis();
     }
 }
 
 void GuiManager::markAllComponentsDirty() {
-    for (auto* component : m_components) {
+    for (auto* component : components()) {
         if (component != nullptr) {
             component->markDirty();
         }
@@ -240,14 +480,31 @@ void GuiManager::markAllComponentsDirty() {
 }
 
 bool GuiManager::handleComponentTouch() {
-    bool touchHandled = false;
-    for (auto* component : m_components) {
-        if (component != nullptr && component->checkTouching(m_lcd)) {
-            component->markDirty();  // Mark for redraw to show visual feedback
-            component->clicked();
-            touchHandled = true;
-            break;  // Handle only the first touched component
+    // Read the controller once per frame rather than once per component
+    int x = 0, y = 0;
+    bool touching = m_lcd.getTouch(&x, &y);
+    if (m_watchdog != nullptr) {
+        m_watchdog->mark(FramePhase::TouchRead);
+    }
+    if (m_recorder != nullptr) {
+        m_recorder->recordTouch(touching, x, y, millis());
+    }
+    if (touching) {
+        m_lastActivityMs.store(millis());
+    }
+    if (m_suppressTouch) {
+        if (touching) {
+            return false;
         }
+        m_suppressTouch = false;
+    }
+
+    // Culled subtrees are skipped, a held press stays with its component
+    Component* pressed = touchComponentList(components(), m_pressed, touching, {x, y}, screenRect());
+    if (pressed == nullptr) {
+        return false;
     }
-    return touchHandled;
-}
\ No newline at end of file
+    pressed->markDirty();  // Mark for redraw to show visual feedback
+    pressed->clicked();
+    return true;
+}
@@ -1,13 +1,38 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <Preferences.h>
 #include "ESP32_SPI_9341.h"
 #include "component.hpp"
 #include "button.hpp"
+#include "container.hpp"
+#include "page.hpp"
+#include "theme.hpp"
+#include "animation.hpp"
+#include "../comm/messages.hpp"
+#include "../trace/TraceRecorder.hpp"
+#include "../diag/FrameWatchdog.hpp"
+#include "PaletteBuffer.hpp"
 
 #define DEFAULT_TEXT_SIZE 3
 
+// Loop pacing: poll touch at the idle rate, step faster while animations run
+#define IDLE_FRAME_MS 20
+#define ANIMATION_FRAME_MS 10
+#define SUSPENDED_FRAME_MS 100
+
+// How long the UI counts as busy after the last touch, redraw or host update
+#define BUSY_HOLD_MS 500
+
+// Upper bound of host updates applied per frame, keeps a burst from stalling rendering
+#define MAX_MESSAGES_PER_FRAME 16
+
+// Hidden pages kept as 4 bpp snapshots (~38 KB each at 320x240)
+#define MAX_CACHED_PAGES 2
+
+using MessageHandler = Delegate<void(const MixerMessage&)>;
+
 class GuiManager {
    public:
     GuiManager(LGFX& lcd);
@@ -18,7 +43,15 @@ class GuiManager {
     void update();
     void clear();
 
-    // Component management
+    // The drawing part of update(): dirty components only, no messages or touch
+    void drawComponents();
+
+    // Pages, the GUI starts on a default page so single-screen use needs no setup
+    Page* createPage(const char* name);
+    void showPage(Page* page);
+    Page* getCurrentPage() const;
+
+    // Component management, acting on the current page
     void addComponent(Component* component);
     void removeComponent(Component* component);
     void clearComponents();
@@ -46,18 +79,68 @@ class GuiManager {
     void println(const String& text);
     void fillScreen(uint16_t color);
 
+    // Theming
+    void setTheme(const Theme& theme);
+    const Theme& getTheme() const;
+
+    // Animation
+    Animator& getAnimator();
+    bool isAnimating() const;
+    uint32_t getFrameDelay() const;
+
+    // Power management, setSuspended may be called from another task
+    void setSuspended(bool suspended);
+    bool isSuspended() const;
+    uint32_t getLastActivityMs() const;
+    bool isBusy() const;
+
+    // Host messaging, the queues are owned by the caller
+    void setMessageQueues(InboxQueue* inbox, OutboxQueue* outbox);
+    bool postEvent(const MixerMessage& message);
+    MessageHandler onMessage;
+
+    // Record touch and host input for replay on the host (src/native/trace_replay.cpp)
+    void setTraceRecorder(TraceRecorder* recorder);
+
+    // Time each frame and keep a post-mortem of the ones over budget
+    void setFrameWatchdog(FrameWatchdog* watchdog);
+
+    // Renders the current page within region (screen coordinates) into a strip at
+    // least that large, for the screen mirror. False while a component there is
+    // still waiting to be drawn on the panel, the strip would show it early.
+    bool renderRegion(PaletteBuffer& strip, const Rectangle& region);
+
     // Getters
     int getWidth() const;
     int getHeight() const;
 
    private:
     LGFX& m_lcd;
-    std::vector<Component*> m_components;
+    std::vector<Page*> m_pages;
+    std::vector<Page*> m_snapshotOrder;  // Cached hidden pages, least recently left first
+    Page* m_currentPage;
+    Component* m_pressed;  // Top-level component holding the current press
     int m_textSize;
     uint16_t m_textColor;
+    const Theme* m_theme;
+    Animator m_animator;
+    InboxQueue* m_inbox;
+    OutboxQueue* m_outbox;
+    std::atomic<bool> m_suspendRequested;
+    bool m_suspended;
+    bool m_suppressTouch;  // Ignore touches until release, set after waking
+    std::atomic<uint32_t> m_lastActivityMs;
+    uint32_t m_lastWorkMs;
     Preferences m_preferences;
+    TraceRecorder* m_recorder;
+    FrameWatchdog* m_watchdog;
 
     // Helper functions
-    void drawComponents();
+    void drainMessages();
+    void applySuspend();
     bool handleComponentTouch();
+    void cacheSnapshot(Page* page);
+    std::vector<Component*>& components();
+    Rectangle screenRect() const;
+    void releasePress();
 };
\ No newline at end of file
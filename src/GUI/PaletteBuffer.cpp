@@ -0,0 +1,198 @@
+#include "PaletteBuffer.hpp"
+
+#include <string.h>
+
+#include "../diag/MemoryTags.hpp"
+
+#define PALETTE_ROW_MAX 320
+
+PaletteBuffer::PaletteBuffer()
+    : m_depth(PaletteDepth::Bits4), m_width(0), m_height(0), m_created(false), m_paletteCount(0), m_indexedTheme() {
+    memset(m_palette, 0, sizeof(m_palette));
+}
+
+PaletteBuffer::~PaletteBuffer() {
+    release();
+}
+
+bool PaletteBuffer::create(int width, int height, PaletteDepth depth) {
+    release();
+
+    m_sprite.setColorDepth(depth == PaletteDepth::Bits4 ? lgfx::palette_4bit : lgfx::palette_8bit);
+    if (m_sprite.createSprite(width, height) == nullptr) {
+        return false;  // Not enough heap
+    }
+
+    m_depth = depth;
+    m_width = width;
+    m_height = height;
+    m_created = true;
+    m_paletteCount = 0;
+    memAlloc(MemTag::Sprites, getBufferBytes());
+    return true;
+}
+
+void PaletteBuffer::release() {
+    if (m_created) {
+        memFree(MemTag::Sprites, getBufferBytes());
+        m_sprite.deleteSprite();
+        m_created = false;
+    }
+}
+
+bool PaletteBuffer::isCreated() const {
+    return m_created;
+}
+
+size_t PaletteBuffer::getBufferBytes() const {
+    if (!m_created) {
+        return 0;
+    }
+    return m_depth == PaletteDepth::Bits4 ? ((m_width + 1) / 2) * m_height : m_width * m_height;
+}
+
+uint16_t PaletteBuffer::paletteSize() const {
+    return m_depth == PaletteDepth::Bits4 ? 16 : 256;
+}
+
+void PaletteBuffer::setEntry(uint8_t index, uint16_t color) {
+    m_palette[index] = color;
+    m_sprite.setPaletteColor(index, (color >> 8) & 0xF8, (color >> 3) & 0xFC, (color << 3) & 0xF8);
+}
+
+uint8_t PaletteBuffer::indexOf(uint16_t color) {
+    for (uint16_t i = 0; i < m_paletteCount; i++) {
+        if (m_palette[i] == color) {
+            return i;
+        }
+    }
+
+    if (m_paletteCount < paletteSize()) {
+        setEntry(m_paletteCount, color);
+        return m_paletteCount++;
+    }
+
+    // Palette full, pick the closest entry by squared 565 channel distance
+    int r = color >> 11, g = (color >> 5) & 0x3F, b = color & 0x1F;
+    uint8_t best = 0;
+    int32_t bestDistance = INT32_MAX;
+    for (uint16_t i = 0; i < m_paletteCount; i++) {
+        int dr = r - (m_palette[i] >> 11);
+        int dg = (g - ((m_palette[i] >> 5) & 0x3F)) / 2;
+        int db = b - (m_palette[i] & 0x1F);
+        int32_t distance = dr * dr + dg * dg + db * db;
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+uint16_t PaletteBuffer::colorOf(uint8_t index) const {
+    return m_palette[index];
+}
+
+void PaletteBuffer::setPalette(const uint16_t* colors, uint16_t count) {
+    m_paletteCount = std::min(count, paletteSize());
+    for (uint16_t i = 0; i < m_paletteCount; i++) {
+        setEntry(i, colors[i]);
+    }
+}
+
+uint16_t PaletteBuffer::getPaletteCount() const {
+    return m_paletteCount;
+}
+
+uint8_t PaletteBuffer::indexAt(int x, int y) const {
+    if (!m_created || x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return 0;
+    }
+    const uint8_t* pixels = static_cast<const uint8_t*>(m_sprite.getBuffer());
+    if (m_depth == PaletteDepth::Bits4) {
+        uint8_t packed = pixels[y * ((m_width + 1) / 2) + (x >> 1)];
+        return (x & 1) ? (packed & 0x0F) : (packed >> 4);
+    }
+    return pixels[y * m_width + x];
+}
+
+void PaletteBuffer::bindTheme(const Theme& theme) {
+    m_paletteCount = 0;
+
+    // Palette sprites draw with palette indices, so components render through a
+    // copy of the theme whose colors are replaced by their palette slot
+    m_indexedTheme = theme;
+    m_indexedTheme.screen = indexOf(theme.screen);
+    for (auto& style : m_indexedTheme.styles) {
+        style.background = indexOf(style.background);
+        style.foreground = indexOf(style.foreground);
+        style.border = indexOf(style.border);
+    }
+}
+
+const Theme& PaletteBuffer::getIndexedTheme() const {
+    return m_indexedTheme;
+}
+
+lgfx::LovyanGFX& PaletteBuffer::getCanvas() {
+    return m_sprite;
+}
+
+void PaletteBuffer::clear() {
+    m_sprite.fillScreen(m_indexedTheme.screen);
+}
+
+void PaletteBuffer::renderComponent(Component& component, int originX, int originY) {
+    Rectangle screenBounds = component.bounds;
+    component.bounds = Rectangle(screenBounds.origin.x - originX, screenBounds.origin.y - originY, screenBounds.w, screenBounds.h);
+
+    component.markDirty();
+    component.draw(m_sprite, m_indexedTheme);
+
+    component.bounds = screenBounds;
+}
+
+void PaletteBuffer::push(lgfx::LovyanGFX& target, int x, int y) {
+    if (m_created) {
+        m_sprite.pushSprite(&target, x, y);
+    }
+}
+
+void PaletteBuffer::pushRegion(lgfx::LovyanGFX& target, int targetX, int targetY, const Rectangle& source, const uint16_t* colors) const {
+    if (!m_created) {
+        return;
+    }
+
+    int x0 = std::max(0, source.origin.x);
+    int y0 = std::max(0, source.origin.y);
+    int x1 = std::min(m_width, source.origin.x + source.w);
+    int y1 = std::min(m_height, source.origin.y + source.h);
+    int width = x1 - x0;
+    if (width <= 0 || y1 <= y0 || width > PALETTE_ROW_MAX) {
+        return;
+    }
+
+    const uint8_t* pixels = static_cast<const uint8_t*>(m_sprite.getBuffer());
+    const uint16_t* palette = colors != nullptr ? colors : m_palette;
+    uint16_t row[PALETTE_ROW_MAX];
+
+    target.startWrite();
+    target.setAddrWindow(targetX + (x0 - source.origin.x), targetY + (y0 - source.origin.y), width, y1 - y0);
+    for (int y = y0; y < y1; y++) {
+        if (m_depth == PaletteDepth::Bits4) {
+            // Rows are padded to whole bytes, the left pixel is in the high nibble
+            const uint8_t* line = pixels + y * ((m_width + 1) / 2);
+            for (int x = x0; x < x1; x++) {
+                uint8_t packed = line[x >> 1];
+                row[x - x0] = palette[(x & 1) ? (packed & 0x0F) : (packed >> 4)];
+            }
+        } else {
+            const uint8_t* line = pixels + y * m_width;
+            for (int x = x0; x < x1; x++) {
+                row[x - x0] = palette[line[x]];
+            }
+        }
+        target.writePixels(row, width);
+    }
+    target.endWrite();
+}
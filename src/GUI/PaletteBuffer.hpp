@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+
+#include "ESP32_SPI_9341.h"
+#include "component.hpp"
+#include "theme.hpp"
+
+enum class PaletteDepth : uint8_t {
+    Bits4 = 4,  // 16 colors, 2 pixels per byte
+    Bits8 = 8   // 256 colors
+};
+
+// Off-screen buffer that stores palette indices instead of RGB565, cutting RAM
+// by 4x (4 bpp) or 2x (8 bpp). Components render into it through an indexed
+// copy of the theme; pushes expand indices back to 565 through a lookup table.
+class PaletteBuffer {
+   public:
+    PaletteBuffer();
+    ~PaletteBuffer();
+
+    bool create(int width, int height, PaletteDepth depth);
+    void release();
+    bool isCreated() const;
+    size_t getBufferBytes() const;
+
+    // Resets the palette to the theme's colors; renders must use getIndexedTheme()
+    void bindTheme(const Theme& theme);
+    const Theme& getIndexedTheme() const;
+
+    // Palette slot for an arbitrary color, added while there is room, otherwise the nearest entry
+    uint8_t indexOf(uint16_t color);
+    uint16_t colorOf(uint8_t index) const;
+
+    // Fixed palette for pixels drawn by index rather than through the theme (images)
+    void setPalette(const uint16_t* colors, uint16_t count);
+    uint16_t getPaletteCount() const;
+
+    // Palette index of one pixel, 0 outside the buffer
+    uint8_t indexAt(int x, int y) const;
+
+    lgfx::LovyanGFX& getCanvas();
+    void clear();
+
+    // Render a component with its screen position translated by the buffer origin
+    void renderComponent(Component& component, int originX = 0, int originY = 0);
+
+    // Whole buffer through LovyanGFX's own palette conversion
+    void push(lgfx::LovyanGFX& target, int x, int y);
+
+    // Part of the buffer, expanded row by row through the 565 table, or through
+    // colors (one value per palette entry) when given. Ignores the target's clip rect.
+    void pushRegion(lgfx::LovyanGFX& target, int targetX, int targetY, const Rectangle& source, const uint16_t* colors = nullptr) const;
+
+   private:
+    mutable lgfx::LGFX_Sprite m_sprite;  // getBuffer() is not const
+    PaletteDepth m_depth;
+    int m_width;
+    int m_height;
+    bool m_created;
+    uint16_t m_palette[256];  // RGB565 copy used for expansion
+    uint16_t m_paletteCount;
+    Theme m_indexedTheme;
+
+    uint16_t paletteSize() const;
+    void setEntry(uint8_t index, uint16_t color);
+};
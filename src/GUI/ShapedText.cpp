@@ -0,0 +1,360 @@
+#include "ShapedText.hpp"
+
+#include <string.h>
+
+#include "../diag/MemoryTags.hpp"
+
+// Bidirectional classes this reduced algorithm distinguishes
+enum class BidiClass : uint8_t {
+    L,   // Left-to-right letter, also anything not listed below
+    R,   // Hebrew, Arabic and the other right-to-left scripts
+    EN,  // European digit
+    N    // Space and punctuation, takes the direction of its neighbours
+};
+
+static uint32_t s_shapedCount = 0;
+
+static bool isDropped(uint32_t codepoint) {
+    // Combining marks: Latin, Hebrew points and cantillation, Arabic harakat
+    if ((codepoint >= 0x0300 && codepoint <= 0x036F) || (codepoint >= 0x0591 && codepoint <= 0x05BD) || codepoint == 0x05BF ||
+        codepoint == 0x05C1 || codepoint == 0x05C2 || codepoint == 0x05C4 || codepoint == 0x05C5 || codepoint == 0x05C7 ||
+        (codepoint >= 0x0610 && codepoint <= 0x061A) || (codepoint >= 0x064B && codepoint <= 0x065F) || codepoint == 0x0670) {
+        return true;
+    }
+    // Invisible formatting: zero width spaces and joiners, direction marks, embeddings, byte order mark
+    return (codepoint >= 0x200B && codepoint <= 0x200F) || (codepoint >= 0x202A && codepoint <= 0x202E) ||
+           (codepoint >= 0x2066 && codepoint <= 0x2069) || codepoint == 0xFEFF;
+}
+
+static BidiClass classify(uint32_t codepoint) {
+    if (codepoint >= '0' && codepoint <= '9') {
+        return BidiClass::EN;
+    }
+    if (codepoint < 0x80) {
+        bool letter = (codepoint >= 'A' && codepoint <= 'Z') || (codepoint >= 'a' && codepoint <= 'z');
+        return letter ? BidiClass::L : BidiClass::N;
+    }
+    if ((codepoint >= 0x0590 && codepoint <= 0x08FF) || (codepoint >= 0xFB1D && codepoint <= 0xFDFF) ||
+        (codepoint >= 0xFE70 && codepoint <= 0xFEFE) || (codepoint >= 0x10800 && codepoint <= 0x10FFF)) {
+        return BidiClass::R;
+    }
+    if ((codepoint >= 0x00A0 && codepoint <= 0x00BF) || codepoint == 0x00D7 || codepoint == 0x00F7 ||
+        (codepoint >= 0x2010 && codepoint <= 0x205E) || (codepoint >= 0x3000 && codepoint <= 0x3003) || codepoint == REPLACEMENT_CHARACTER) {
+        return BidiClass::N;
+    }
+    return BidiClass::L;
+}
+
+#define BRACKET_STACK_DEPTH 63  // BD16: deeper nesting stops the pairing
+
+// Opening and closing brackets that pair up (BD14, BD15), 0 for anything else
+static uint32_t closingBracket(uint32_t codepoint) {
+    switch (codepoint) {
+        case '(':
+            return ')';
+        case '[':
+            return ']';
+        case '{':
+            return '}';
+        default:
+            return 0;
+    }
+}
+
+static bool isClosingBracket(uint32_t codepoint) {
+    return codepoint == ')' || codepoint == ']' || codepoint == '}';
+}
+
+// Digits count as right-to-left when neutrals and brackets take a direction
+static BidiClass strongDirection(BidiClass bidiClass) {
+    return bidiClass == BidiClass::EN ? BidiClass::R : bidiClass;
+}
+
+// N0: both brackets of a pair take the paragraph direction when the text
+// between them has it, or the opposite direction when only that is inside and
+// the text before the pair has it too. Pairs without strong text inside stay
+// neutral for N1. Pairs resolve in the order they open, so an outer pair counts
+// as strong text for the ones after it.
+static void resolveBrackets(const uint32_t* codepoints, BidiClass* classes, int count, BidiClass paragraph) {
+    struct Pair {
+        int16_t open, close;
+    };
+    Pair pairs[SHAPED_MAX_CODEPOINTS / 2];
+    int pairCount = 0;
+
+    // BD16: a closing bracket pairs with the nearest open one of its kind, dropping those above it
+    int16_t stack[BRACKET_STACK_DEPTH];
+    int depth = 0;
+    for (int i = 0; i < count; i++) {
+        if (classes[i] != BidiClass::N) {
+            continue;
+        }
+        if (closingBracket(codepoints[i]) != 0) {
+            if (depth == BRACKET_STACK_DEPTH) {
+                break;
+            }
+            stack[depth++] = i;
+        } else if (isClosingBracket(codepoints[i])) {
+            for (int level = depth - 1; level >= 0; level--) {
+                if (closingBracket(codepoints[stack[level]]) == codepoints[i]) {
+                    pairs[pairCount++] = {stack[level], (int16_t)i};
+                    depth = level;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Found by their closing bracket, resolved by their opening one
+    for (int a = 1; a < pairCount; a++) {
+        Pair pair = pairs[a];
+        int b = a;
+        for (; b > 0 && pairs[b - 1].open > pair.open; b--) {
+            pairs[b] = pairs[b - 1];
+        }
+        pairs[b] = pair;
+    }
+
+    BidiClass opposite = paragraph == BidiClass::L ? BidiClass::R : BidiClass::L;
+    for (int p = 0; p < pairCount; p++) {
+        const Pair& pair = pairs[p];
+        bool embedding = false, other = false;
+        for (int i = pair.open + 1; i < pair.close; i++) {
+            BidiClass inside = strongDirection(classes[i]);
+            embedding |= inside == paragraph;
+            other |= inside == opposite;
+        }
+        if (!embedding && !other) {
+            continue;
+        }
+
+        BidiClass resolved = paragraph;
+        if (!embedding) {
+            BidiClass before = paragraph;
+            for (int i = pair.open - 1; i >= 0; i--) {
+                if (classes[i] != BidiClass::N) {
+                    before = strongDirection(classes[i]);
+                    break;
+                }
+            }
+            resolved = before == opposite ? opposite : paragraph;
+        }
+        classes[pair.open] = resolved;
+        classes[pair.close] = resolved;
+    }
+}
+
+// Paired punctuation shows mirrored inside right-to-left runs (rule L4)
+static uint32_t mirrored(uint32_t codepoint) {
+    static const uint32_t PAIRS[][2] = {{'(', ')'}, {'[', ']'}, {'{', '}'}, {'<', '>'}, {0x00AB, 0x00BB}, {0x2039, 0x203A}};
+    for (const auto& pair : PAIRS) {
+        if (codepoint == pair[0]) {
+            return pair[1];
+        }
+        if (codepoint == pair[1]) {
+            return pair[0];
+        }
+    }
+    return codepoint;
+}
+
+int decodeUtf8(const char* text, uint32_t* codepoints, int capacity) {
+    static const uint32_t MINIMUM[] = {0, 0x80, 0x800, 0x10000};
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(text);
+    int count = 0;
+    while (*p != '\0' && count < capacity) {
+        uint32_t codepoint;
+        int extra;
+        if (*p < 0x80) {
+            codepoint = *p;
+            extra = 0;
+        } else if ((*p & 0xE0) == 0xC0) {
+            codepoint = *p & 0x1F;
+            extra = 1;
+        } else if ((*p & 0xF0) == 0xE0) {
+            codepoint = *p & 0x0F;
+            extra = 2;
+        } else if ((*p & 0xF8) == 0xF0) {
+            codepoint = *p & 0x07;
+            extra = 3;
+        } else {
+            p++;
+            codepoints[count++] = REPLACEMENT_CHARACTER;
+            continue;
+        }
+        p++;
+
+        int i = 0;
+        for (; i < extra && (*p & 0xC0) == 0x80; i++, p++) {
+            codepoint = (codepoint << 6) | (*p & 0x3F);
+        }
+        if (i < extra || codepoint < MINIMUM[extra] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+            codepoint = REPLACEMENT_CHARACTER;
+        }
+        if (!isDropped(codepoint)) {
+            codepoints[count++] = codepoint;
+        }
+    }
+    return count;
+}
+
+bool reorderBidi(uint32_t* codepoints, int count) {
+    BidiClass classes[SHAPED_MAX_CODEPOINTS];
+    uint8_t levels[SHAPED_MAX_CODEPOINTS];
+
+    // P2, P3: the first strong letter sets the paragraph direction
+    for (int i = 0; i < count; i++) {
+        classes[i] = classify(codepoints[i]);
+    }
+    bool rightToLeft = false;
+    for (int i = 0; i < count; i++) {
+        if (classes[i] == BidiClass::L || classes[i] == BidiClass::R) {
+            rightToLeft = classes[i] == BidiClass::R;
+            break;
+        }
+    }
+    BidiClass paragraph = rightToLeft ? BidiClass::R : BidiClass::L;
+
+    // W7: digits after a left-to-right letter, or at the start of a left-to-right paragraph, are left-to-right
+    BidiClass lastStrong = paragraph;
+    for (int i = 0; i < count; i++) {
+        if (classes[i] == BidiClass::L || classes[i] == BidiClass::R) {
+            lastStrong = classes[i];
+        } else if (classes[i] == BidiClass::EN && lastStrong == BidiClass::L) {
+            classes[i] = BidiClass::L;
+        }
+    }
+
+    resolveBrackets(codepoints, classes, count, paragraph);
+
+    // N1, N2: neutrals between two runs of the same direction take it (digits
+    // count as right-to-left here), any other neutrals take the paragraph's
+    for (int i = 0; i < count;) {
+        if (classes[i] != BidiClass::N) {
+            i++;
+            continue;
+        }
+        int end = i;
+        while (end < count && classes[end] == BidiClass::N) {
+            end++;
+        }
+        BidiClass before = i == 0 ? paragraph : (classes[i - 1] == BidiClass::L ? BidiClass::L : BidiClass::R);
+        BidiClass after = end == count ? paragraph : (classes[end] == BidiClass::L ? BidiClass::L : BidiClass::R);
+        BidiClass resolved = before == after ? before : paragraph;
+        for (; i < end; i++) {
+            classes[i] = resolved;
+        }
+    }
+
+    // I1, I2: embedding levels, digits always one above the right-to-left text around them
+    uint8_t highest = 0;
+    for (int i = 0; i < count; i++) {
+        if (!rightToLeft) {
+            levels[i] = classes[i] == BidiClass::L ? 0 : (classes[i] == BidiClass::R ? 1 : 2);
+        } else {
+            levels[i] = classes[i] == BidiClass::R ? 1 : 2;
+        }
+        highest = levels[i] > highest ? levels[i] : highest;
+    }
+
+    // L2: from the highest level down to the lowest odd one, reverse every run at or above it
+    for (uint8_t level = highest; level >= 1; level--) {
+        for (int i = 0; i < count;) {
+            if (levels[i] < level) {
+                i++;
+                continue;
+            }
+            int end = i;
+            while (end < count && levels[end] >= level) {
+                end++;
+            }
+            for (int a = i, b = end - 1; a < b; a++, b--) {
+                uint32_t codepoint = codepoints[a];
+                codepoints[a] = codepoints[b];
+                codepoints[b] = codepoint;
+                uint8_t swapped = levels[a];
+                levels[a] = levels[b];
+                levels[b] = swapped;
+            }
+            i = end;
+        }
+    }
+
+    // L4
+    for (int i = 0; i < count; i++) {
+        if (levels[i] & 1) {
+            codepoints[i] = mirrored(codepoints[i]);
+        }
+    }
+    return rightToLeft;
+}
+
+ShapedRun::ShapedRun() : m_width(0), m_rightToLeft(false) {
+    m_visual[0] = '\0';
+}
+
+ShapedRun::~ShapedRun() {
+    memResize(MemTag::Strings, m_glyphs.capacity() * sizeof(PlacedGlyph), 0);
+}
+
+void ShapedRun::shape(const char* text, const AtlasFontData* font) {
+    s_shapedCount++;
+
+    uint32_t codepoints[SHAPED_MAX_CODEPOINTS];
+    int count = decodeUtf8(text, codepoints, SHAPED_MAX_CODEPOINTS);
+    m_rightToLeft = reorderBidi(codepoints, count);
+
+    m_glyphs.clear();  // Keeps the capacity, labels settle at their length
+    m_width = 0;
+    if (font == nullptr) {
+        // The built-in font covers printable ASCII only
+        for (int i = 0; i < count; i++) {
+            m_visual[i] = codepoints[i] >= 0x20 && codepoints[i] < 0x7F ? (char)codepoints[i] : '?';
+        }
+        m_visual[count] = '\0';
+        return;
+    }
+    m_visual[0] = '\0';
+
+    const AtlasGlyph* fallback = AtlasFont::findGlyph(*font, '?');
+    uint16_t previous = 0;
+    int pen = 0;
+    for (int i = 0; i < count; i++) {
+        const AtlasGlyph* glyph = codepoints[i] <= 0xFFFF ? AtlasFont::findGlyph(*font, codepoints[i]) : nullptr;
+        if (glyph == nullptr) {
+            glyph = fallback;
+            if (glyph == nullptr) {
+                continue;
+            }
+        }
+        pen += AtlasFont::kerning(*font, previous, glyph->codepoint);
+
+        size_t capacity = m_glyphs.capacity();
+        m_glyphs.push_back({glyph, (int16_t)(pen + glyph->xOffset)});
+        memTrackGrowth(MemTag::Strings, m_glyphs, capacity);
+
+        pen += glyph->advance;
+        previous = glyph->codepoint;
+    }
+    m_width = pen;
+}
+
+bool ShapedRun::isRightToLeft() const {
+    return m_rightToLeft;
+}
+
+int ShapedRun::getWidth() const {
+    return m_width;
+}
+
+const char* ShapedRun::getVisualText() const {
+    return m_visual;
+}
+
+void ShapedRun::draw(lgfx::LovyanGFX& gfx, const AtlasFontData& font, int x, int y, uint16_t foreground, uint16_t background) const {
+    AtlasFont::drawPlaced(gfx, font, m_glyphs.data(), m_glyphs.size(), x, y, foreground, background);
+}
+
+uint32_t shapedRunCount() {
+    return s_shapedCount;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+
+#include <vector>
+
+#include "AtlasFont.hpp"
+
+#define SHAPED_MAX_CODEPOINTS 64  // Longer labels are cut, session names are far shorter
+#define REPLACEMENT_CHARACTER 0xFFFD
+
+// A label laid out once for display. The UTF-8 text is decoded, put into
+// visual order with a reduced form of the Unicode bidirectional algorithm
+// (one paragraph, no embeddings or isolates: strong letters, European digits,
+// paired brackets and neutrals between them, mirrored brackets in right-to-left
+// runs) and its glyphs are looked up and positioned. Redraws only walk the
+// placed glyphs.
+//
+// Combining marks are dropped and Arabic letters keep their isolated forms,
+// the atlas fonts carry no positioning or joining data.
+class ShapedRun {
+   public:
+    ShapedRun();
+    ~ShapedRun();
+
+    // Lays out text for an atlas font, or for the built-in font when font is nullptr
+    void shape(const char* text, const AtlasFontData* font);
+
+    // Paragraph direction, from the first strong letter
+    bool isRightToLeft() const;
+
+    // Atlas fonts: width in pixels including kerning
+    int getWidth() const;
+
+    // Built-in font: the text in visual order, characters it cannot show as '?'
+    const char* getVisualText() const;
+
+    void draw(lgfx::LovyanGFX& gfx, const AtlasFontData& font, int x, int y, uint16_t foreground, uint16_t background) const;
+
+   private:
+    std::vector<PlacedGlyph> m_glyphs;
+    char m_visual[SHAPED_MAX_CODEPOINTS + 1];
+    int16_t m_width;
+    bool m_rightToLeft;
+};
+
+uint32_t shapedRunCount();  // Labels shaped since boot
+
+// Decodes up to capacity codepoints and returns how many. Malformed, truncated
+// and overlong sequences each become one U+FFFD; combining marks and invisible
+// formatting characters are dropped.
+int decodeUtf8(const char* text, uint32_t* codepoints, int capacity);
+
+// Reorders at most SHAPED_MAX_CODEPOINTS codepoints from logical to visual
+// order, returns whether the paragraph is right-to-left
+bool reorderBidi(uint32_t* codepoints, int count);
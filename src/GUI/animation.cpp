@@ -0,0 +1,139 @@
+#include "animation.hpp"
+#include "Arduino.h"
+#include "component.hpp"
+
+static Animator* s_componentAnimator = nullptr;
+
+void setComponentAnimator(Animator* animator) {
+    s_componentAnimator = animator;
+}
+
+Animator* componentAnimator() {
+    return s_componentAnimator;
+}
+
+int32_t applyEasing(Easing easing, int32_t t) {
+    if (t <= 0) return 0;
+    if (t >= ANIM_ONE) return ANIM_ONE;
+
+    int64_t x = t;
+    switch (easing) {
+        case Easing::EaseIn:
+            return (int32_t)((x * x) >> ANIM_SHIFT);
+        case Easing::EaseOut: {
+            int64_t inv = ANIM_ONE - x;
+            return ANIM_ONE - (int32_t)((inv * inv) >> ANIM_SHIFT);
+        }
+        case Easing::EaseInOut: {
+            // Smoothstep: t * t * (3 - 2t)
+            int64_t sq = (x * x) >> ANIM_SHIFT;
+            return (int32_t)((sq * (3 * ANIM_ONE - 2 * x)) >> ANIM_SHIFT);
+        }
+        case Easing::Linear:
+        default:
+            return t;
+    }
+}
+
+Animator::Animator() : m_activeCount(0) {
+    for (auto& animation : m_animations) {
+        animation.active = false;
+    }
+}
+
+Animation* Animator::find(int* value) {
+    for (auto& animation : m_animations) {
+        if (animation.active && animation.value == value) {
+            return &animation;
+        }
+    }
+    return nullptr;
+}
+
+bool Animator::animate(Component* target, int* value, int to, uint16_t durationMs, Easing easing) {
+    if (value == nullptr) {
+        return false;
+    }
+
+    Animation* slot = find(value);
+    if (slot == nullptr) {
+        for (auto& animation : m_animations) {
+            if (!animation.active) {
+                slot = &animation;
+                m_activeCount++;
+                break;
+            }
+        }
+    }
+
+    // Pool exhausted, jump straight to the end value
+    if (slot == nullptr) {
+        *value = to;
+        if (target != nullptr) {
+            target->markDirty();
+        }
+        return false;
+    }
+
+    slot->target = target;
+    slot->value = value;
+    slot->from = *value;
+    slot->to = to;
+    slot->startMs = millis();
+    slot->durationMs = durationMs > 0 ? durationMs : 1;
+    slot->easing = easing;
+    slot->active = true;
+    return true;
+}
+
+void Animator::cancel(int* value) {
+    Animation* animation = find(value);
+    if (animation != nullptr) {
+        animation->active = false;
+        m_activeCount--;
+    }
+}
+
+void Animator::cancelAll(Component* target) {
+    for (auto& animation : m_animations) {
+        if (animation.active && animation.target == target) {
+            animation.active = false;
+            m_activeCount--;
+        }
+    }
+}
+
+bool Animator::update(uint32_t nowMs) {
+    if (m_activeCount == 0) {
+        return false;
+    }
+
+    for (auto& animation : m_animations) {
+        if (!animation.active) {
+            continue;
+        }
+
+        uint32_t elapsed = nowMs - animation.startMs;
+        int32_t t = elapsed >= animation.durationMs ? ANIM_ONE : (int32_t)(((int64_t)elapsed << ANIM_SHIFT) / animation.durationMs);
+        int32_t eased = applyEasing(animation.easing, t);
+
+        int next = animation.from + (int)(((int64_t)(animation.to - animation.from) * eased) >> ANIM_SHIFT);
+        if (next != *animation.value) {
+            *animation.value = next;
+            if (animation.target != nullptr) {
+                animation.target->markDirty();  // Only the animated component is repainted
+            }
+        }
+
+        if (t >= ANIM_ONE) {
+            animation.active = false;
+            m_activeCount--;
+        }
+    }
+
+    return m_activeCount > 0;
+}
+
+bool Animator::isActive() const {
+    return m_activeCount > 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+
+class Component;
+
+// Progress and easing values are Q16.16 fixed point, 0 .. ANIM_ONE
+#define ANIM_SHIFT 16
+#define ANIM_ONE (1 << ANIM_SHIFT)
+
+enum class Easing : uint8_t {
+    Linear,
+    EaseIn,
+    EaseOut,
+    EaseInOut
+};
+
+int32_t applyEasing(Easing easing, int32_t t);
+
+struct Animation {
+    Component* target;  // Marked dirty on every step
+    int* value;         // Property being tweened
+    int from;
+    int to;
+    uint32_t startMs;
+    uint16_t durationMs;
+    Easing easing;
+    bool active;
+};
+
+// Fixed pool of property tweens. Nothing is allocated; starting an animation on
+// a property that is already animating retargets it from its current value.
+class Animator {
+   public:
+    static const int MAX_ANIMATIONS = 8;
+
+    Animator();
+
+    bool animate(Component* target, int* value, int to, uint16_t durationMs, Easing easing = Easing::EaseOut);
+    void cancel(int* value);
+    void cancelAll(Component* target);
+
+    // Advance every active animation, returns true while any are still running
+    bool update(uint32_t nowMs);
+    bool isActive() const;
+
+   private:
+    Animation m_animations[MAX_ANIMATIONS];
+    uint8_t m_activeCount;
+
+    Animation* find(int* value);
+};
+
+// The animator components use for their own transitions, such as the press
+// highlight. GuiManager registers its own; nullptr makes them jump to the end.
+void setComponentAnimator(Animator* animator);
+Animator* componentAnimator();
@@ -1,28 +1,62 @@
 #include "button.hpp"
 
-void Button::draw(LGFX lcd) {
+void Button::draw(lgfx::LovyanGFX& lcd, const Theme& theme) {
     // Only draw if the button needs redrawing
     if (!needsRedraw) {
         return;
     }
 
-    // Draw button background
-    lcd.fillRect(bounds.origin.x, bounds.origin.y, bounds.w, bounds.h, TFT_LIGHTGRAY);
+    replayList(lcd, theme);
 
-    // Calculate text dimensions
-    int16_t textWidth = lcd.textWidth(this->text);
-    int16_t textHeight = lcd.fontHeight();
+    // Mark as clean since we just drew it
+    markClean();
+}
 
-    // Calculate centered position
-    Point middle = bounds.getMiddle();
-    int16_t textX = middle.x - (textWidth / 2);
-    int16_t textY = middle.y - (textHeight / 2);
+void Button::setText(const String& value) {
+    if (value == text) {
+        return;
+    }
+    memResize(MemTag::Strings, text.length() + 1, value.length() + 1);
+    text = value;
+    invalidateList();
+}
 
-    // Set proper text colors - black text on the light gray button background
-    lcd.setTextColor(TFT_BLACK, TFT_LIGHTGRAY);  // text color, background color
-    lcd.setCursor(textX, textY);
-    lcd.print(this->text);
+const String& Button::getText() const {
+    return text;
+}
 
-    // Mark as clean since we just drew it
-    markClean();
+void Button::record(DisplayList& list, lgfx::LovyanGFX& lcd, const Theme& theme) {
+    // Background, with a frame only when the style asks for one
+    list.fillRect(0, 0, bounds.w, bounds.h, ColorRole::Background);
+    list.frame(0, 0, bounds.w, bounds.h);
+
+    // UTF-8 decoding, bidi reordering and glyph lookup happen here once, not on every repaint
+    Point middle = {bounds.w / 2, bounds.h / 2};
+    run.shape(text.c_str(), theme.font);
+    if (theme.font != nullptr) {
+        // Anti-aliased atlas font when the theme has one
+        int textWidth = run.getWidth();
+        list.atlasText(middle.x - (textWidth / 2), middle.y - (theme.font->lineHeight / 2), textWidth, theme.font->lineHeight, &run,
+                       ColorRole::Foreground, ColorRole::Background);
+        return;
+    }
+
+    int16_t textWidth = lcd.textWidth(run.getVisualText());
+    int16_t textHeight = lcd.fontHeight();
+
+    // A label wider than the button steps down to the largest text size that
+    // fits instead of spilling into its neighbours; the built-in font scales linearly
+    uint8_t textSize = 0;
+    int room = bounds.w - 2 * BUTTON_TEXT_PADDING;
+    int currentSize = (int)lcd.getTextSizeX();
+    if (textWidth > room && currentSize > 1) {
+        int fitted = std::max(1, room * currentSize / textWidth);
+        if (fitted < currentSize) {
+            textSize = fitted;
+            textWidth = textWidth * fitted / currentSize;
+            textHeight = textHeight * fitted / currentSize;
+        }
+    }
+    list.text(middle.x - (textWidth / 2), middle.y - (textHeight / 2), textWidth, textHeight, run.getVisualText(), ColorRole::Foreground,
+              ColorRole::Background, textSize);
 }
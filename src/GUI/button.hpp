@@ -1,17 +1,32 @@
+#pragma once
 #include "Arduino.h"
 #include "component.hpp"
+#include "AtlasFont.hpp"
+#include "ShapedText.hpp"
+
+#define BUTTON_TEXT_PADDING 2  // Each side, built-in font labels shrink to fit inside
 
 class Button : public Component {
    public:
     Button(Rectangle rect, String text) : Component(rect) {
         this->text = text;
-        this->onClick = Button::func;
+        memAlloc(MemTag::Strings, this->text.length() + 1);
+    }
+    ~Button() override {
+        memFree(MemTag::Strings, text.length() + 1);
+    }
+    void draw(lgfx::LovyanGFX& lcd, const Theme& theme);
+    bool isOpaque() const override {
+        return true;
     }
-    static void func() {
-        Serial.println("IM HERE");
-    };
-    void draw(LGFX lcd);
+
+    void setText(const String& value);
+    const String& getText() const;
+
+   protected:
+    void record(DisplayList& list, lgfx::LovyanGFX& lcd, const Theme& theme) override;
 
    private:
     String text;
+    ShapedRun run;  // Laid out when the list records, i.e. once per text or font change
 };
\ No newline at end of file
@@ -1,50 +1,219 @@
 #pragma once
+#include "../delegate.hpp"
+#include "../diag/MemoryTags.hpp"
 #include "../utils.hpp"
+#include "DisplayList.hpp"
 #include "ESP32_SPI_9341.h"
+#include "animation.hpp"
+#include "theme.hpp"
+class Component;
+
+// After a release the pressed style fades back through the component animator
+#define PRESS_FADE_MS 150
+#define PRESS_LEVEL_FULL 255
+
+// Event handlers carry their own context (session index, owning strip, ...)
+using ClickHandler = Delegate<void(Component&)>;
+using DragHandler = Delegate<void(Component&, Point)>;
+using ValueHandler = Delegate<void(Component&, int)>;
+
+// Creation order, so ids stay the same from boot to boot for the same UI
+inline uint16_t nextComponentId() {
+    static uint16_t next = 0;
+    return ++next;
+}
+
 class Component {
    public:
-    Rectangle bounds;
+    const uint16_t id = nextComponentId();  // Names the component in diagnostics
+    Rectangle bounds;  // Relative to the parent container, screen coordinates at the top level
     bool needsRedraw;
+    bool childrenDirty = false;  // Some descendant needs a redraw
+    Component* parent = nullptr;
+    uint8_t styleId = STYLE_NORMAL;  // Index into the active Theme
+    bool enabled = true;
 
     Component(Rectangle& rect) {
         this->bounds = rect;
         this->needsRedraw = true;  // Initially needs to be drawn
     }
-    virtual void draw(LGFX lcd) = 0;
+    virtual ~Component() {
+        Animator* animator = componentAnimator();
+        if (animator != nullptr) {
+            animator->cancelAll(this);
+        }
+    }
+
+    // Widgets are created with new, counted so leaks show up in the memory report
+    static void* operator new(size_t size) {
+        memAlloc(MemTag::Components, size);
+        return ::operator new(size);
+    }
+    static void operator delete(void* pointer, size_t size) {
+        memFree(MemTag::Components, size);
+        ::operator delete(pointer);
+    }
+    virtual void draw(lgfx::LovyanGFX& lcd, const Theme& theme) = 0;
+
+    // The retained commands are stale, e.g. the text changed; styles and position are resolved on replay
+    void invalidateList() {
+        displayList.invalidate();
+        markDirty();
+    }
+
+    // Stops the animations of this subtree, for components taken out of the GUI.
+    // Deleted components stop their own.
+    virtual void cancelAnimations() {
+        Animator* animator = componentAnimator();
+        if (animator != nullptr) {
+            animator->cancelAll(this);
+        }
+    }
+
+    // Paints every pixel of its bounds, so siblings it fully covers can be skipped
+    virtual bool isOpaque() const {
+        return false;
+    }
+
+    // Touch for this component's subtree, pos in the parent's coordinates.
+    // Returns the component a new press landed on.
+    virtual Component* touch(bool touching, Point pos) {
+        return checkTouching(touching, pos) ? this : nullptr;
+    }
+
+    // Theme switch: redraw only what is drawn with a style that changed
+    virtual void invalidateStyles(const Theme& previous, const Theme& next) {
+        if (previous.get(currentStyle()) != next.get(currentStyle())) {
+            markDirty();
+        }
+    }
 
     void markDirty() {
         needsRedraw = true;
+        for (Component* ancestor = parent; ancestor != nullptr && !ancestor->childrenDirty; ancestor = ancestor->parent) {
+            ancestor->childrenDirty = true;
+        }
     }
 
     void markClean() {
         needsRedraw = false;
     }
 
-    bool checkTouching(LGFX lcd) {
-        int pos[2] = {0, 0};
-        if (lcd.getTouch(&pos[0], &pos[1])) {
+    void setStyle(uint8_t id) {
+        if (styleId != id) {
+            styleId = id;
+            markDirty();
+        }
+    }
+
+    void setEnabled(bool value) {
+        if (enabled != value) {
+            enabled = value;
+            markDirty();
+        }
+    }
+
+    // The style slot the component should be drawn with right now
+    uint8_t currentStyle() const {
+        if (!enabled) {
+            return STYLE_DISABLED;
+        }
+        return isDebouncing ? static_cast<uint8_t>(STYLE_PRESSED) : styleId;
+    }
+
+    bool isPressed() const {
+        return isDebouncing;
+    }
+
+    // Feed the current touch state, returns true when a press starts on this component.
+    // A held press that moves reports drag events until it is released.
+    bool checkTouching(bool touching, Point pos) {
+        if (touching) {
             if (this->isDebouncing) {
+                if (pos.x != lastTouch.x || pos.y != lastTouch.y) {
+                    lastTouch = pos;
+                    dragged(pos);
+                }
+                return false;
+            }
+            if (!this->enabled) {
                 return false;
             }
-            auto didTouch = this->bounds.checkInside({pos[0], pos[1]});
-            // Serial.printf("touch: %d %d touched? %s", pos[0], pos[1], didTouch ? "YES" : "NO");
+            auto didTouch = this->bounds.checkInside(pos);
+            // Serial.printf("touch: %d %d touched? %s", pos.x, pos.y, didTouch ? "YES" : "NO");
             this->isDebouncing = didTouch;
+            lastTouch = pos;
+            if (didTouch) {
+                showPressed();
+            }
             return didTouch;
-        } else {
+        } else if (this->isDebouncing) {
             this->isDebouncing = false;
+            fadePressed();
         }
 
         return false;
     }
     void clicked() {
-        // if (this->onClick) {
-        this->onClick();
-        // }
+        if (this->onClick) {
+            this->onClick(*this);
+        }
     };
+    void dragged(Point pos) {
+        if (this->onDrag) {
+            this->onDrag(*this, pos);
+        }
+    }
+    void valueChanged(int value) {
+        if (this->onValueChanged) {
+            this->onValueChanged(*this, value);
+        }
+    }
 
-    //    private:
-    f_void onClick;
+    ClickHandler onClick;
+    DragHandler onDrag;
+    ValueHandler onValueChanged;
+
+   protected:
+    DisplayList displayList;
+
+    // Emits the commands draw() replays, relative to the top left corner of bounds
+    virtual void record(DisplayList&, lgfx::LovyanGFX&, const Theme&) {
+    }
+
+    // Records when stale, then replays within the current clip rect
+    void replayList(lgfx::LovyanGFX& lcd, const Theme& theme) {
+        if (displayList.isStale(bounds.w, bounds.h, theme.font, lcd.fontHeight())) {
+            displayList.begin(bounds.w, bounds.h, theme.font, lcd.fontHeight());
+            record(displayList, lcd, theme);
+        }
+        Style style = theme.get(currentStyle());
+        if (pressLevel > 0 && !isDebouncing && enabled) {
+            style = mixStyles(style, theme.get(STYLE_PRESSED), pressLevel, lcd.hasPalette());
+        }
+        int32_t clipX, clipY, clipW, clipH;
+        lcd.getClipRect(&clipX, &clipY, &clipW, &clipH);
+        displayList.replay(lcd, theme, style, bounds.origin, Rectangle(clipX, clipY, clipW, clipH));
+    }
 
    private:
     bool isDebouncing = false;
-};
\ No newline at end of file
+    Point lastTouch = {0, 0};
+    int pressLevel = 0;  // How much of the pressed style shows, PRESS_LEVEL_FULL while held
+
+    void showPressed() {
+        Animator* animator = componentAnimator();
+        if (animator != nullptr) {
+            animator->cancel(&pressLevel);
+        }
+        pressLevel = PRESS_LEVEL_FULL;
+    }
+
+    void fadePressed() {
+        Animator* animator = componentAnimator();
+        if (animator == nullptr || !animator->animate(this, &pressLevel, 0, PRESS_FADE_MS)) {
+            pressLevel = 0;
+        }
+        markDirty();  // Drop the pressed style, the fade repaints from here
+    }
+};
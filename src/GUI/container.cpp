@@ -0,0 +1,286 @@
+#include "container.hpp"
+#include "../diag/FrameWatchdog.hpp"
+
+#include <algorithm>
+
+bool isCulled(const std::vector<Component*>& siblings, size_t index, const Rectangle& clip) {
+    const Component* component = siblings[index];
+    if (!component->bounds.intersects(clip)) {
+        return true;
+    }
+    for (size_t i = index + 1; i < siblings.size(); i++) {
+        const Component* above = siblings[i];
+        if (above != nullptr && above->isOpaque() && above->bounds.contains(component->bounds)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static DamageHandler s_damageHandler;
+
+void setDamageHandler(const DamageHandler& handler) {
+    s_damageHandler = handler;
+}
+
+void reportDamage(const Rectangle& area) {
+    if (s_damageHandler && area.w > 0 && area.h > 0) {
+        s_damageHandler(area);
+    }
+}
+
+bool drawComponentList(std::vector<Component*>& siblings, lgfx::LovyanGFX& lcd, const Theme& theme, Point origin, const Rectangle& clip) {
+    bool drewAny = false;
+    for (size_t i = 0; i < siblings.size(); i++) {
+        Component* component = siblings[i];
+        if (component == nullptr || !(component->needsRedraw || component->childrenDirty) || isCulled(siblings, i, clip)) {
+            continue;  // Culled components stay dirty and draw once uncovered
+        }
+
+        // Components draw in screen coordinates, so local bounds are shifted for the call
+        Rectangle local = component->bounds;
+        component->bounds = local.translated(origin.x, origin.y);
+        if (component->needsRedraw) {
+            // A container redrawing only some children reports those instead
+            reportDamage(component->bounds.intersection(clip.translated(origin.x, origin.y)));
+        }
+        FrameWatchdog* watchdog = FrameWatchdog::current();
+        uint32_t startUs = 0;
+        if (watchdog != nullptr) {
+            watchdog->componentStarted(*component);
+            startUs = micros();
+        }
+        component->draw(lcd, theme);
+        if (watchdog != nullptr) {
+            watchdog->componentDrawn(*component, micros() - startUs);
+        }
+        component->bounds = local;
+        drewAny = true;
+    }
+    return drewAny;
+}
+
+Component* touchComponentList(std::vector<Component*>& siblings, Component*& pressed, bool touching, Point pos, const Rectangle& clip) {
+    if (pressed != nullptr) {
+        // Drags and the release go to the press owner wherever the finger is now
+        Component* hit = pressed->touch(touching, pos);
+        if (!touching) {
+            pressed = nullptr;
+        }
+        return hit;
+    }
+    if (!touching || !clip.contains(pos)) {
+        return nullptr;
+    }
+
+    // Later siblings draw on top, so they get the first chance
+    for (size_t i = siblings.size(); i-- > 0;) {
+        Component* component = siblings[i];
+        if (component == nullptr || !component->bounds.contains(pos) || isCulled(siblings, i, clip)) {
+            continue;
+        }
+        Component* hit = component->touch(true, pos);
+        if (hit != nullptr) {
+            pressed = component;
+            return hit;
+        }
+    }
+    return nullptr;
+}
+
+Container::Container(Rectangle rect) : Component(rect), m_pressed(nullptr), m_scroll({0, 0}) {
+}
+
+Container::~Container() {
+    clearChildren();
+    memResize(MemTag::Components, m_children.capacity() * sizeof(Component*), 0);
+}
+
+void Container::addChild(Component* child) {
+    if (child == nullptr) {
+        return;
+    }
+    child->parent = this;
+    size_t capacity = m_children.capacity();
+    m_children.push_back(child);
+    memTrackGrowth(MemTag::Components, m_children, capacity);
+    layout();
+    child->markDirty();
+}
+
+bool Container::removeChild(Component* child) {
+    auto it = std::find(m_children.begin(), m_children.end(), child);
+    if (it == m_children.end()) {
+        return false;
+    }
+    if (m_pressed == child) {
+        m_pressed = nullptr;
+    }
+    m_children.erase(it);
+    child->cancelAnimations();  // Detached, it must not keep marking itself dirty
+    child->parent = nullptr;
+    layout();
+    markDirty();  // Uncovers background
+    return true;
+}
+
+void Container::clearChildren() {
+    for (auto* child : m_children) {
+        delete child;
+    }
+    m_children.clear();
+    m_pressed = nullptr;
+    markDirty();
+}
+
+std::vector<Component*>& Container::getChildren() {
+    return m_children;
+}
+
+void Container::draw(lgfx::LovyanGFX& lcd, const Theme& theme) {
+    // A full redraw paints over the children, so all of them follow
+    if (needsRedraw) {
+        replayList(lcd, theme);
+        for (auto* child : m_children) {
+            if (child != nullptr) {
+                child->markDirty();
+            }
+        }
+        markClean();
+    }
+    if (!childrenDirty) {
+        return;
+    }
+    childrenDirty = false;
+
+    // Children are clipped to our bounds within whatever clip the parent set
+    int32_t clipX, clipY, clipW, clipH;
+    lcd.getClipRect(&clipX, &clipY, &clipW, &clipH);
+    Rectangle screenClip = bounds.intersection(Rectangle(clipX, clipY, clipW, clipH));
+    if (screenClip.w > 0 && screenClip.h > 0) {
+        Point origin = {bounds.origin.x - m_scroll.x, bounds.origin.y - m_scroll.y};
+        lcd.setClipRect(screenClip.origin.x, screenClip.origin.y, screenClip.w, screenClip.h);
+        drawComponentList(m_children, lcd, theme, origin, screenClip.translated(-origin.x, -origin.y));
+        lcd.setClipRect(clipX, clipY, clipW, clipH);
+    }
+}
+
+void Container::record(DisplayList& list, lgfx::LovyanGFX&, const Theme&) {
+    list.fillRect(0, 0, bounds.w, bounds.h, ColorRole::Screen);
+}
+
+bool Container::isOpaque() const {
+    return true;
+}
+
+Component* Container::touch(bool touching, Point pos) {
+    // Our own press (scrolling, container handlers) keeps the children out of it
+    if (isPressed()) {
+        checkTouching(touching, pos);
+        return nullptr;
+    }
+
+    if (touching || m_pressed != nullptr) {
+        Point local = {pos.x - bounds.origin.x + m_scroll.x, pos.y - bounds.origin.y + m_scroll.y};
+        bool childHeld = m_pressed != nullptr;
+        Component* hit = touchComponentList(m_children, m_pressed, touching, local, Rectangle(m_scroll, bounds.w, bounds.h));
+        if (hit != nullptr || childHeld) {
+            return hit;
+        }
+    }
+
+    if (touching && isPressable() && checkTouching(true, pos)) {
+        return this;
+    }
+    return nullptr;
+}
+
+void Container::invalidateStyles(const Theme& previous, const Theme& next) {
+    if (previous.screen != next.screen || previous.get(currentStyle()) != next.get(currentStyle())) {
+        markDirty();
+        return;
+    }
+    for (auto* child : m_children) {
+        if (child != nullptr) {
+            child->invalidateStyles(previous, next);
+        }
+    }
+}
+
+void Container::cancelAnimations() {
+    Component::cancelAnimations();
+    for (auto* child : m_children) {
+        if (child != nullptr) {
+            child->cancelAnimations();
+        }
+    }
+}
+
+void Container::layout() {
+}
+
+bool Container::isPressable() const {
+    return static_cast<bool>(onClick) || static_cast<bool>(onDrag);
+}
+
+Panel::Panel(Rectangle rect) : Container(rect) {
+}
+
+void Panel::record(DisplayList& list, lgfx::LovyanGFX&, const Theme&) {
+    list.fillRect(0, 0, bounds.w, bounds.h, ColorRole::Background);
+    list.frame(0, 0, bounds.w, bounds.h);
+}
+
+Row::Row(Rectangle rect, int spacing) : Container(rect), m_spacing(spacing) {
+}
+
+void Row::layout() {
+    int x = 0;
+    for (auto* child : m_children) {
+        if (child != nullptr) {
+            child->bounds = Rectangle(x, 0, child->bounds.w, bounds.h);
+            x += child->bounds.w + m_spacing;
+        }
+    }
+}
+
+ScrollView::ScrollView(Rectangle rect) : Container(rect), m_dragY(0) {
+}
+
+void ScrollView::scrollTo(int y) {
+    y = std::max(0, std::min(y, getContentHeight() - bounds.h));
+    if (y != m_scroll.y) {
+        m_scroll.y = y;
+        markDirty();
+    }
+}
+
+int ScrollView::getScrollY() const {
+    return m_scroll.y;
+}
+
+int ScrollView::getContentHeight() const {
+    int height = 0;
+    for (const auto* child : m_children) {
+        if (child != nullptr) {
+            height = std::max(height, child->bounds.origin.y + child->bounds.h);
+        }
+    }
+    return height;
+}
+
+Component* ScrollView::touch(bool touching, Point pos) {
+    bool dragging = isPressed();
+    Component* hit = Container::touch(touching, pos);
+    if (hit == this) {
+        m_dragY = pos.y;
+    } else if (dragging && touching && pos.y != m_dragY) {
+        scrollTo(m_scroll.y + m_dragY - pos.y);
+        m_dragY = pos.y;
+    }
+    return hit;
+}
+
+bool ScrollView::isPressable() const {
+    return true;
+}
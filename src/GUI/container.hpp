@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+
+#include "ESP32_SPI_9341.h"
+#include "component.hpp"
+#include "theme.hpp"
+
+// Sibling list traversal shared by containers and the page level in GuiManager.
+// Bounds in the list are relative to origin (where local 0,0 is on screen);
+// clip is the visible area in the same local coordinates.
+
+// Outside the clip, or fully covered by an opaque sibling drawn after it.
+// The one check that skips a whole subtree for both drawing and touch.
+bool isCulled(const std::vector<Component*>& siblings, size_t index, const Rectangle& clip);
+
+// Draws dirty components and descends into dirty subtrees, returns true if anything was drawn
+bool drawComponentList(std::vector<Component*>& siblings, lgfx::LovyanGFX& lcd, const Theme& theme, Point origin, const Rectangle& clip);
+
+// Screen areas drawComponentList repaints, for consumers that follow the panel
+// contents such as the screen mirror. One handler for the whole GUI.
+using DamageHandler = Delegate<void(const Rectangle&)>;
+void setDamageHandler(const DamageHandler& handler);
+void reportDamage(const Rectangle& area);
+
+// Routes touch: a held press goes to the sibling that took it (pressed), otherwise
+// unculled siblings under pos get the chance to take a new press, topmost first
+Component* touchComponentList(std::vector<Component*>& siblings, Component*& pressed, bool touching, Point pos, const Rectangle& clip);
+
+// A component with children in local coordinates, clipped to its bounds.
+// Owns its children. Fills its background with the screen color.
+class Container : public Component {
+   public:
+    Container(Rectangle rect);
+    ~Container() override;
+
+    void addChild(Component* child);
+    bool removeChild(Component* child);  // The caller takes ownership back
+    void clearChildren();
+    std::vector<Component*>& getChildren();
+
+    void draw(lgfx::LovyanGFX& lcd, const Theme& theme) override;
+    bool isOpaque() const override;
+    Component* touch(bool touching, Point pos) override;
+    void invalidateStyles(const Theme& previous, const Theme& next) override;
+    void cancelAnimations() override;
+
+   protected:
+    std::vector<Component*> m_children;
+    Component* m_pressed;  // Child whose subtree holds the current press
+    Point m_scroll;        // Local coordinates shown at the top left corner
+
+    void record(DisplayList& list, lgfx::LovyanGFX& lcd, const Theme& theme) override;  // The background
+    virtual void layout();
+    virtual bool isPressable() const;
+};
+
+// Container drawn with its style, like a button without text
+class Panel : public Container {
+   public:
+    Panel(Rectangle rect);
+
+   protected:
+    void record(DisplayList& list, lgfx::LovyanGFX& lcd, const Theme& theme) override;
+};
+
+// Lays its children out left to right at full height, keeping their widths
+class Row : public Container {
+   public:
+    Row(Rectangle rect, int spacing = 4);
+
+   protected:
+    int m_spacing;
+
+    void layout() override;
+};
+
+// Vertically scrolling container, dragging on its background scrolls the content
+class ScrollView : public Container {
+   public:
+    ScrollView(Rectangle rect);
+
+    void scrollTo(int y);
+    int getScrollY() const;
+    int getContentHeight() const;
+
+    Component* touch(bool touching, Point pos) override;
+
+   protected:
+    int m_dragY;
+
+    bool isPressable() const override;
+};
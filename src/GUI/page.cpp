@@ -0,0 +1,81 @@
+#include "page.hpp"
+#include <algorithm>
+
+Page::Page(const char* name) : m_name(name), m_snapshot(nullptr) {
+}
+
+Page::~Page() {
+    dropSnapshot();
+    clearComponents();
+    memResize(MemTag::Components, m_components.capacity() * sizeof(Component*), 0);
+}
+
+const char* Page::getName() const {
+    return m_name;
+}
+
+std::vector<Component*>& Page::getComponents() {
+    return m_components;
+}
+
+void Page::addComponent(Component* component) {
+    if (component != nullptr) {
+        size_t capacity = m_components.capacity();
+        m_components.push_back(component);
+        memTrackGrowth(MemTag::Components, m_components, capacity);
+    }
+}
+
+bool Page::removeComponent(Component* component) {
+    auto it = std::find(m_components.begin(), m_components.end(), component);
+    if (it == m_components.end()) {
+        return false;
+    }
+    m_components.erase(it);
+    dropSnapshot();  // The snapshot still shows the removed component
+    return true;
+}
+
+void Page::clearComponents() {
+    for (auto* component : m_components) {
+        delete component;
+    }
+    m_components.clear();
+    dropSnapshot();
+}
+
+bool Page::captureSnapshot(const Theme& theme, int width, int height, int textSize) {
+    if (m_snapshot == nullptr) {
+        m_snapshot = new PaletteBuffer();
+        if (!m_snapshot->create(width, height, PaletteDepth::Bits4)) {
+            delete m_snapshot;
+            m_snapshot = nullptr;
+            return false;  // Not enough heap, the page will be redrawn instead
+        }
+    }
+
+    m_snapshot->bindTheme(theme);
+    m_snapshot->getCanvas().setTextSize(textSize);
+    m_snapshot->clear();
+    for (auto* component : m_components) {
+        m_snapshot->renderComponent(*component);
+    }
+    return true;
+}
+
+void Page::pushSnapshot(LGFX& lcd) {
+    if (m_snapshot != nullptr) {
+        m_snapshot->push(lcd, 0, 0);
+    }
+}
+
+void Page::dropSnapshot() {
+    if (m_snapshot != nullptr) {
+        delete m_snapshot;
+        m_snapshot = nullptr;
+    }
+}
+
+bool Page::hasSnapshot() const {
+    return m_snapshot != nullptr;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include "ESP32_SPI_9341.h"
+#include "component.hpp"
+#include "PaletteBuffer.hpp"
+#include "theme.hpp"
+
+// A screen's worth of components (mixer, app detail, settings). Pages own their
+// components and keep their state while hidden. A hidden page may hold a
+// 4 bpp snapshot of itself so it can be shown again without a full redraw.
+class Page {
+   public:
+    Page(const char* name);
+    ~Page();
+
+    const char* getName() const;
+    std::vector<Component*>& getComponents();
+
+    void addComponent(Component* component);
+    bool removeComponent(Component* component);
+    void clearComponents();
+
+    // Snapshot cache
+    bool captureSnapshot(const Theme& theme, int width, int height, int textSize);
+    void pushSnapshot(LGFX& lcd);
+    void dropSnapshot();
+    bool hasSnapshot() const;
+
+   private:
+    const char* m_name;
+    std::vector<Component*> m_components;
+    PaletteBuffer* m_snapshot;
+};
@@ -0,0 +1,49 @@
+#include "theme.hpp"
+#include "ESP32_SPI_9341.h"
+
+// The atlas is generated at build time from fonts/fonts.txt, fall back when it is missing
+#if __has_include("fonts/ui_font.h")
+#include "fonts/ui_font.h"
+#define THEME_FONT (&ui_font)
+#else
+#define THEME_FONT nullptr
+#endif
+
+const Theme DARK_THEME = {
+    "dark",
+    TFT_BLACK,
+    {
+        // {background, foreground, border}
+        {TFT_LIGHTGRAY, TFT_BLACK, TFT_LIGHTGRAY},  // STYLE_NORMAL
+        {TFT_DARKGRAY, TFT_WHITE, TFT_WHITE},       // STYLE_PRESSED
+        {0x39E7, TFT_DARKGRAY, 0x39E7},             // STYLE_DISABLED
+        {TFT_ORANGE, TFT_BLACK, TFT_ORANGE},        // STYLE_ACCENT
+    },
+    THEME_FONT,
+};
+
+const Theme LIGHT_THEME = {
+    "light",
+    TFT_WHITE,
+    {
+        {0xDEFB, TFT_BLACK, TFT_DARKGRAY},   // STYLE_NORMAL
+        {TFT_DARKGRAY, TFT_WHITE, TFT_BLACK}, // STYLE_PRESSED
+        {0xEF7D, TFT_LIGHTGRAY, 0xEF7D},     // STYLE_DISABLED
+        {TFT_NAVY, TFT_WHITE, TFT_NAVY},      // STYLE_ACCENT
+    },
+    THEME_FONT,
+};
+
+static uint16_t mix565(uint16_t from, uint16_t to, uint8_t amount) {
+    uint32_t rb = (((to & 0xF81F) * amount) + ((from & 0xF81F) * (255 - amount))) / 255;
+    uint32_t g = (((to & 0x07E0) * amount) + ((from & 0x07E0) * (255 - amount))) / 255;
+    return (rb & 0xF81F) | (g & 0x07E0);
+}
+
+Style mixStyles(const Style& from, const Style& to, uint8_t amount, bool indexed) {
+    if (indexed) {
+        return amount >= 128 ? to : from;
+    }
+    return {mix565(from.background, to.background, amount), mix565(from.foreground, to.foreground, amount),
+            mix565(from.border, to.border, amount)};
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+
+struct AtlasFontData;
+
+// Style slots a component refers to by index. The active Theme maps each
+// slot to a shared Style record, so components never store colors themselves.
+enum StyleId : uint8_t {
+    STYLE_NORMAL = 0,
+    STYLE_PRESSED,
+    STYLE_DISABLED,
+    STYLE_ACCENT,
+    STYLE_COUNT
+};
+
+struct Style {
+    uint16_t background;
+    uint16_t foreground;
+    uint16_t border;
+
+    bool operator==(const Style& other) const {
+        return background == other.background && foreground == other.foreground && border == other.border;
+    }
+    bool operator!=(const Style& other) const {
+        return !(*this == other);
+    }
+};
+
+struct Theme {
+    const char* name;
+    uint16_t screen;  // Color behind the components
+    Style styles[STYLE_COUNT];
+    const AtlasFontData* font;  // nullptr draws with the built-in scaled font
+
+    const Style& get(uint8_t id) const {
+        return styles[id < STYLE_COUNT ? id : static_cast<uint8_t>(STYLE_NORMAL)];
+    }
+};
+
+// Mixes two styles, amount 0 gives from and 255 gives to. Palette targets hold
+// color indices that cannot be mixed (indexed), they switch halfway instead.
+Style mixStyles(const Style& from, const Style& to, uint8_t amount, bool indexed);
+
+extern const Theme DARK_THEME;
+extern const Theme LIGHT_THEME;
@@ -0,0 +1,26 @@
+#include "MixerUi.hpp"
+
+void buildMixerUi(GuiManager& gui) {
+    // Create and add GUI components using helper method
+    Button* btn = gui.createButton(10, 10, 200, 100, "hello");
+    btn->onClick = [](Component& component) {
+        LOG_I("hello clicked");
+    };
+}
+
+Row* buildPresetBar(GuiManager& gui, PresetBank& presets) {
+    const int height = 44;
+    const int spacing = 4;
+    Row* bar = new Row(Rectangle(spacing, gui.getHeight() - height - spacing, gui.getWidth() - 2 * spacing, height), spacing);
+    int width = (bar->bounds.w - (presets.getCount() - 1) * spacing) / presets.getCount();
+    for (uint8_t i = 0; i < presets.getCount(); i++) {
+        Button* button = new Button(Rectangle(0, 0, width, height), presets.get(i).name);
+        PresetBank* bank = &presets;
+        button->onClick = [bank, i](Component& component) {
+            bank->apply(i);
+        };
+        bar->addChild(button);
+    }
+    gui.addComponent(bar);
+    return bar;
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "../GUI/GuiManager.hpp"
+#include "../mixer/Presets.hpp"
+
+// Builds the GuiManager screens. Shared by the firmware and the host replay
+// runner so recorded traces hit the same layout they were recorded on.
+void buildMixerUi(GuiManager& gui);
+
+// One button per preset along the bottom edge, a tap applies it as one batch.
+// Returns the bar so other components can be laid out above it.
+Row* buildPresetBar(GuiManager& gui, PresetBank& presets);
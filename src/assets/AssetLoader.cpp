@@ -0,0 +1,246 @@
+#include "AssetLoader.hpp"
+#include "../diag/MemoryTags.hpp"
+#include "../log/Log.hpp"
+
+#include <string.h>
+
+AssetLoader::AssetLoader()
+    : m_panel(nullptr),
+      m_spi(HSPI),
+      m_mounted(false),
+      m_cachedBytes(0),
+      m_useCounter(0),
+      m_pendingHead(0),
+      m_pendingCount(0),
+      m_buffer(nullptr),
+      m_size(0),
+      m_offset(0) {
+    memset(m_cache, 0, sizeof(m_cache));
+}
+
+AssetLoader::~AssetLoader() {
+    clearCache();
+    if (m_buffer != nullptr) {
+        memFree(MemTag::Assets, m_size);
+        free(m_buffer);
+    }
+}
+
+bool AssetLoader::begin(lgfx::LGFX_Device& panel, int sck, int miso, int mosi, int cs) {
+    m_panel = &panel;
+    m_panel->waitDMA();
+    m_spi.begin(sck, miso, mosi, cs);
+    m_mounted = SD.begin(cs, m_spi, ASSET_SPI_FREQ);
+    if (!m_mounted) {
+        LOG_E("SD card mount failed, assets unavailable");
+    }
+    return m_mounted;
+}
+
+bool AssetLoader::isMounted() const {
+    return m_mounted;
+}
+
+bool AssetLoader::claimBus() {
+    // With use_lock both drivers take the host's lock per transaction, so the card
+    // only has to keep out of an open panel write (same task, it would deadlock)
+    // and of a DMA transfer the panel left running.
+    if (!m_mounted || m_panel->getStartCount() > 0) {
+        return false;
+    }
+    m_panel->waitDMA();
+    return true;
+}
+
+AssetLoader::CachedAsset* AssetLoader::findCached(const char* path) {
+    for (auto& asset : m_cache) {
+        if (asset.data != nullptr && strncmp(asset.path, path, ASSET_PATH_LEN) == 0) {
+            asset.lastUsed = ++m_useCounter;
+            return &asset;
+        }
+    }
+    return nullptr;
+}
+
+const uint8_t* AssetLoader::get(const char* path, size_t* size) {
+    CachedAsset* asset = findCached(path);
+    if (asset == nullptr) {
+        return nullptr;
+    }
+    if (size != nullptr) {
+        *size = asset->size;
+    }
+    return asset->data;
+}
+
+bool AssetLoader::request(const char* path, AssetHandler onLoaded) {
+    CachedAsset* asset = findCached(path);
+    if (asset != nullptr) {
+        if (onLoaded) {
+            onLoaded(asset->path, asset->data, asset->size);
+        }
+        return true;
+    }
+
+    if (!m_mounted || m_pendingCount >= ASSET_MAX_PENDING) {
+        return false;
+    }
+
+    Request& request = m_pending[(m_pendingHead + m_pendingCount) % ASSET_MAX_PENDING];
+    strncpy(request.path, path, ASSET_PATH_LEN - 1);
+    request.path[ASSET_PATH_LEN - 1] = '\0';
+    request.onLoaded = onLoaded;
+    m_pendingCount++;
+    return true;
+}
+
+bool AssetLoader::isBusy() const {
+    return m_pendingCount > 0;
+}
+
+void AssetLoader::pump(uint32_t budgetUs) {
+    uint32_t start = micros();
+
+    while (m_pendingCount > 0 && micros() - start < budgetUs) {
+        // Handlers may draw, so the bus is claimed again before each card access
+        if (!claimBus()) {
+            return;
+        }
+        if (m_buffer == nullptr && !startNext()) {
+            continue;
+        }
+
+        size_t chunk = std::min((size_t)ASSET_CHUNK_SIZE, m_size - m_offset);
+        size_t read = m_file.read(m_buffer + m_offset, chunk);
+        if (read != chunk) {
+            finishCurrent(false);
+            continue;
+        }
+
+        m_offset += read;
+        if (m_offset == m_size) {
+            finishCurrent(true);
+        }
+    }
+}
+
+bool AssetLoader::startNext() {
+    Request& request = m_pending[m_pendingHead];
+
+    // An earlier request may have loaded the same file in the meantime
+    CachedAsset* cached = findCached(request.path);
+    if (cached != nullptr) {
+        finishCurrent(true);
+        return false;
+    }
+
+    m_file = SD.open(request.path, FILE_READ);
+    m_size = m_file ? m_file.size() : 0;
+    m_buffer = m_size > 0 && m_size <= ASSET_CACHE_BYTES ? (uint8_t*)malloc(m_size) : nullptr;
+    if (m_buffer == nullptr) {
+        LOG_W("Asset %s missing or too large", request.path);
+        finishCurrent(false);
+        return false;
+    }
+    memAlloc(MemTag::Assets, m_size);
+
+    m_offset = 0;
+    return true;
+}
+
+void AssetLoader::finishCurrent(bool success) {
+    Request& request = m_pending[m_pendingHead];
+
+    if (m_file) {
+        m_file.close();
+    }
+
+    if (success && m_buffer != nullptr) {
+        storeInCache(request.path, m_buffer, m_size);
+        m_buffer = nullptr;  // Owned by the cache now
+    } else if (m_buffer != nullptr) {
+        memFree(MemTag::Assets, m_size);
+        free(m_buffer);
+        m_buffer = nullptr;
+    }
+
+    if (request.onLoaded) {
+        size_t size = 0;
+        const uint8_t* data = success ? get(request.path, &size) : nullptr;
+        request.onLoaded(request.path, data, size);
+    }
+    request.onLoaded = nullptr;
+
+    m_pendingHead = (m_pendingHead + 1) % ASSET_MAX_PENDING;
+    m_pendingCount--;
+    m_size = 0;
+    m_offset = 0;
+}
+
+void AssetLoader::storeInCache(const char* path, uint8_t* data, size_t size) {
+    evictFor(size);
+
+    for (auto& asset : m_cache) {
+        if (asset.data == nullptr) {
+            strncpy(asset.path, path, ASSET_PATH_LEN - 1);
+            asset.path[ASSET_PATH_LEN - 1] = '\0';
+            asset.data = data;
+            asset.size = size;
+            asset.lastUsed = ++m_useCounter;
+            m_cachedBytes += size;
+            return;
+        }
+    }
+    memFree(MemTag::Assets, size);
+    free(data);  // evictFor always leaves a free slot, kept for safety
+}
+
+void AssetLoader::evictFor(size_t size) {
+    for (;;) {
+        CachedAsset* oldest = nullptr;
+        bool slotFree = false;
+        for (auto& asset : m_cache) {
+            if (asset.data == nullptr) {
+                slotFree = true;
+            } else if (oldest == nullptr || asset.lastUsed < oldest->lastUsed) {
+                oldest = &asset;
+            }
+        }
+
+        if ((slotFree && m_cachedBytes + size <= ASSET_CACHE_BYTES) || oldest == nullptr) {
+            return;
+        }
+
+        m_cachedBytes -= oldest->size;
+        memFree(MemTag::Assets, oldest->size);
+        free(oldest->data);
+        oldest->data = nullptr;
+    }
+}
+
+uint8_t* AssetLoader::take(const char* path, size_t* size) {
+    CachedAsset* asset = findCached(path);
+    if (asset == nullptr) {
+        return nullptr;
+    }
+    uint8_t* data = asset->data;
+    *size = asset->size;
+    m_cachedBytes -= asset->size;
+    asset->data = nullptr;
+    return data;
+}
+
+void AssetLoader::clearCache() {
+    for (auto& asset : m_cache) {
+        if (asset.data != nullptr) {
+            memFree(MemTag::Assets, asset.size);
+            free(asset.data);
+            asset.data = nullptr;
+        }
+    }
+    m_cachedBytes = 0;
+}
+
+size_t AssetLoader::getCachedBytes() const {
+    return m_cachedBytes;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <SD.h>
+#include <SPI.h>
+
+#include "Arduino.h"
+#include "ESP32_SPI_9341.h"
+#include "../delegate.hpp"
+
+#define ASSET_PATH_LEN 48
+#define ASSET_CHUNK_SIZE 512
+#define ASSET_FRAME_BUDGET_US 2000
+#define ASSET_CACHE_BYTES (48 * 1024)
+#define ASSET_CACHE_SLOTS 16
+#define ASSET_MAX_PENDING 8
+#define ASSET_SPI_FREQ 20000000
+
+using AssetHandler = Delegate<void(const char* path, const uint8_t* data, size_t size)>;
+
+// Loads fonts, icons and page layouts from the SD card without stalling frames.
+// The card shares the panel's SPI host (bus_shared in ESP32_SPI_9341.h), touch
+// keeps the other one to itself. Reads happen in ASSET_CHUNK_SIZE pieces from
+// pump(), which the UI loop calls between frames, and stop as soon as the
+// per-frame budget is spent. Finished assets stay in a RAM cache (least
+// recently used evicted first) up to ASSET_CACHE_BYTES.
+class AssetLoader {
+   public:
+    AssetLoader();
+    ~AssetLoader();
+
+    // sck/miso/mosi are the panel's bus pins, cs the card's own select
+    bool begin(lgfx::LGFX_Device& panel, int sck, int miso, int mosi, int cs);
+    bool isMounted() const;
+
+    // True when the card may be accessed now: no panel write is open and its
+    // DMA has finished. Anything else touching the card checks this first.
+    bool claimBus();
+
+    // Cached data, or nullptr when the asset still has to be requested
+    const uint8_t* get(const char* path, size_t* size);
+
+    // Queue a load; the handler runs from pump() once the whole asset is in RAM
+    // (immediately if it is already cached). data is nullptr if the read failed.
+    bool request(const char* path, AssetHandler onLoaded);
+
+    void pump(uint32_t budgetUs = ASSET_FRAME_BUDGET_US);
+    bool isBusy() const;
+
+    // Removes a cached asset and hands its buffer over, nullptr if it is not cached.
+    // The caller frees it and keeps it reported under MemTag::Assets until then.
+    uint8_t* take(const char* path, size_t* size);
+
+    void clearCache();
+    size_t getCachedBytes() const;
+
+   private:
+    struct CachedAsset {
+        char path[ASSET_PATH_LEN];
+        uint8_t* data;
+        size_t size;
+        uint32_t lastUsed;
+    };
+
+    struct Request {
+        char path[ASSET_PATH_LEN];
+        AssetHandler onLoaded;
+    };
+
+    lgfx::LGFX_Device* m_panel;
+    SPIClass m_spi;
+    bool m_mounted;
+    CachedAsset m_cache[ASSET_CACHE_SLOTS];
+    size_t m_cachedBytes;
+    uint32_t m_useCounter;
+
+    Request m_pending[ASSET_MAX_PENDING];
+    uint8_t m_pendingHead;
+    uint8_t m_pendingCount;
+
+    // Load in progress
+    File m_file;
+    uint8_t* m_buffer;
+    size_t m_size;
+    size_t m_offset;
+
+    CachedAsset* findCached(const char* path);
+    bool startNext();  // Opens the oldest request, false if it finished at once (cached or unreadable)
+    void finishCurrent(bool success);
+    void storeInCache(const char* path, uint8_t* data, size_t size);
+    void evictFor(size_t size);
+};
@@ -0,0 +1,118 @@
+#include "FontFile.hpp"
+#include "../diag/MemoryTags.hpp"
+#include "../log/Log.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define FONT_HEADER_BYTES 14
+#define FONT_GLYPH_BYTES 11
+#define FONT_KERN_BYTES 5
+
+static uint16_t read16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t read32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+FontFile::FontFile() : m_glyphs(nullptr), m_kerns(nullptr), m_data(nullptr), m_size(0) {
+    memset(&m_font, 0, sizeof(m_font));
+}
+
+FontFile::~FontFile() {
+    release();
+}
+
+bool FontFile::load(uint8_t* data, size_t size) {
+    release();
+    m_data = data;
+    m_size = size;
+
+    if (size < FONT_HEADER_BYTES || read32(data) != FONT_FILE_MAGIC) {
+        LOG_W("Font file has no UMF1 header");
+        release();
+        return false;
+    }
+    uint16_t glyphCount = read16(data + 6);
+    uint16_t kernCount = read16(data + 8);
+    uint32_t bitmapBytes = read32(data + 10);
+    size_t glyphTable = FONT_HEADER_BYTES;
+    size_t kernTable = glyphTable + glyphCount * FONT_GLYPH_BYTES;
+    size_t bitmaps = kernTable + kernCount * FONT_KERN_BYTES;
+    if (glyphCount == 0 || bitmaps + bitmapBytes != size) {
+        LOG_W("Font file size does not match its header");
+        release();
+        return false;
+    }
+
+    m_glyphs = (AtlasGlyph*)malloc(glyphCount * sizeof(AtlasGlyph));
+    m_kerns = kernCount > 0 ? (AtlasKern*)malloc(kernCount * sizeof(AtlasKern)) : nullptr;
+    if (m_glyphs == nullptr || (kernCount > 0 && m_kerns == nullptr)) {
+        LOG_E("No memory for the font tables");
+        free(m_glyphs);
+        free(m_kerns);
+        m_glyphs = nullptr;
+        m_kerns = nullptr;
+        release();
+        return false;
+    }
+    m_font.glyphCount = glyphCount;
+    m_font.kernCount = kernCount;
+    memAlloc(MemTag::Assets, glyphCount * sizeof(AtlasGlyph) + kernCount * sizeof(AtlasKern));
+
+    for (uint16_t i = 0; i < glyphCount; i++) {
+        const uint8_t* p = data + glyphTable + i * FONT_GLYPH_BYTES;
+        AtlasGlyph& glyph = m_glyphs[i];
+        glyph.codepoint = read16(p);
+        glyph.width = p[2];
+        glyph.height = p[3];
+        glyph.xOffset = (int8_t)p[4];
+        glyph.yOffset = (int8_t)p[5];
+        glyph.advance = p[6];
+        glyph.offset = read32(p + 7);
+
+        // The decoder trusts widths and offsets, a corrupt file must not send it past the bitmaps
+        bool sorted = i == 0 || m_glyphs[i - 1].codepoint < glyph.codepoint;
+        if (!sorted || glyph.width > ATLAS_MAX_GLYPH_WIDTH || glyph.offset >= bitmapBytes) {
+            LOG_W("Font file glyph %u is invalid", i);
+            release();
+            return false;
+        }
+    }
+    for (uint16_t i = 0; i < kernCount; i++) {
+        const uint8_t* p = data + kernTable + i * FONT_KERN_BYTES;
+        m_kerns[i].left = read16(p);
+        m_kerns[i].right = read16(p + 2);
+        m_kerns[i].adjust = (int8_t)p[4];
+    }
+
+    m_font.lineHeight = data[4];
+    m_font.ascent = data[5];
+    m_font.glyphs = m_glyphs;
+    m_font.kerns = m_kerns;
+    m_font.bitmaps = data + bitmaps;
+    return true;
+}
+
+const AtlasFontData* FontFile::get() const {
+    return m_font.glyphs != nullptr ? &m_font : nullptr;
+}
+
+void FontFile::release() {
+    if (m_glyphs != nullptr || m_kerns != nullptr) {
+        memFree(MemTag::Assets, m_font.glyphCount * sizeof(AtlasGlyph) + m_font.kernCount * sizeof(AtlasKern));
+    }
+    free(m_glyphs);
+    free(m_kerns);
+    if (m_data != nullptr) {
+        memFree(MemTag::Assets, m_size);
+        free(m_data);
+    }
+    m_glyphs = nullptr;
+    m_kerns = nullptr;
+    m_data = nullptr;
+    m_size = 0;
+    memset(&m_font, 0, sizeof(m_font));
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../GUI/AtlasFont.hpp"
+
+#define FONT_FILE_MAGIC 0x31464D55  // "UMF1"
+
+// An AtlasFont kept on the SD card, for glyph sets too large for the flash
+// partition (tools/fontconv.py --binary). Little-endian and packed:
+//   header   u32 magic, u8 lineHeight, u8 ascent, u16 glyphCount, u16 kernCount, u32 bitmapBytes
+//   glyphs   u16 codepoint, u8 width, u8 height, i8 xOffset, i8 yOffset, u8 advance, u32 offset
+//   kerns    u16 left, u16 right, i8 adjust
+//   bitmaps  run-length coded coverage as described in AtlasFont.hpp
+// Glyph and kerning tables are unpacked into arrays, the bitmaps are used in place.
+class FontFile {
+   public:
+    FontFile();
+    ~FontFile();
+
+    // Takes the file's buffer (malloc'd, reported under MemTag::Assets, e.g. from
+    // AssetLoader::take) in every case; false if it is not a valid font
+    bool load(uint8_t* data, size_t size);
+
+    // nullptr until a font has loaded
+    const AtlasFontData* get() const;
+
+   private:
+    AtlasFontData m_font;
+    AtlasGlyph* m_glyphs;
+    AtlasKern* m_kerns;
+    uint8_t* m_data;
+    size_t m_size;
+
+    void release();
+};
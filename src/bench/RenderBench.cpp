@@ -0,0 +1,107 @@
+#if defined(UNIMIX_RENDER_BENCH) && defined(UNIMIX_USE_LVGL)
+#include "RenderBench.hpp"
+
+struct BenchStats {
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+
+    void reset() {
+        minUs = UINT32_MAX;
+        maxUs = 0;
+        totalUs = 0;
+    }
+
+    void add(uint32_t us) {
+        minUs = std::min(minUs, us);
+        maxUs = std::max(maxUs, us);
+        totalUs += us;
+    }
+
+    void print(Print& out, const char* name, uint32_t firstFrameUs) {
+        out.printf("[bench] %-10s first %6lu us  min %6lu us  avg %6lu us  max %6lu us\n", name, (unsigned long)firstFrameUs,
+                   (unsigned long)minUs, (unsigned long)(totalUs / BENCH_FRAMES), (unsigned long)maxUs);
+    }
+};
+
+static const int BUTTON_COUNT = BENCH_COLUMNS * BENCH_ROWS;
+
+static Rectangle cellBounds(LGFX& lcd, int index) {
+    int w = lcd.width() / BENCH_COLUMNS;
+    int h = lcd.height() / BENCH_ROWS;
+    return Rectangle((index % BENCH_COLUMNS) * w + 4, (index / BENCH_COLUMNS) * h + 4, w - 8, h - 8);
+}
+
+static void benchGuiManager(GuiManager& gui, LGFX& lcd, Print& out) {
+    Page* page = gui.createPage("bench");
+    gui.showPage(page);
+
+    Button* buttons[BUTTON_COUNT];
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        buttons[i] = gui.createButton(cellBounds(lcd, i), String(i));
+    }
+
+    // Drawing only, like lv_refr_now() below; update() would add messages and a touch read
+    uint32_t start = micros();
+    gui.drawComponents();
+    uint32_t firstFrameUs = micros() - start;
+
+    BenchStats stats;
+    stats.reset();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        Button* button = buttons[frame % BUTTON_COUNT];
+        button->setStyle(button->styleId == STYLE_ACCENT ? STYLE_NORMAL : STYLE_ACCENT);
+
+        start = micros();
+        gui.drawComponents();
+        stats.add(micros() - start);
+    }
+    stats.print(out, "GuiManager", firstFrameUs);
+}
+
+static void benchLvgl(LvglBackend& lvgl, LGFX& lcd, Print& out) {
+    lv_obj_t* screen = lv_obj_create(NULL);
+    lv_obj_t* buttons[BUTTON_COUNT];
+    for (int i = 0; i < BUTTON_COUNT; i++) {
+        Rectangle bounds = cellBounds(lcd, i);
+        buttons[i] = lv_btn_create(screen);
+        lv_obj_set_pos(buttons[i], bounds.origin.x, bounds.origin.y);
+        lv_obj_set_size(buttons[i], bounds.w, bounds.h);
+        lv_obj_add_flag(buttons[i], LV_OBJ_FLAG_CHECKABLE);
+
+        lv_obj_t* label = lv_label_create(buttons[i]);
+        lv_label_set_text_fmt(label, "%d", i);
+        lv_obj_center(label);
+    }
+    lv_scr_load(screen);
+
+    uint32_t start = micros();
+    lv_refr_now(NULL);
+    uint32_t firstFrameUs = micros() - start;
+
+    BenchStats stats;
+    stats.reset();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        lv_obj_t* button = buttons[frame % BUTTON_COUNT];
+        if (lv_obj_has_state(button, LV_STATE_CHECKED)) {
+            lv_obj_clear_state(button, LV_STATE_CHECKED);
+        } else {
+            lv_obj_add_state(button, LV_STATE_CHECKED);
+        }
+
+        start = micros();
+        lv_refr_now(NULL);
+        stats.add(micros() - start);
+    }
+    stats.print(out, "LVGL", firstFrameUs);
+    out.printf("[bench] LVGL last refresh %lu px in %lu flushes\n", (unsigned long)lvgl.getLastRefreshPixels(),
+               (unsigned long)lvgl.getFlushCount());
+}
+
+void runRenderBench(GuiManager& gui, LvglBackend& lvgl, LGFX& lcd, Print& out) {
+    out.printf("[bench] %d frames, %dx%d button grid, one toggle per frame\n", BENCH_FRAMES, BENCH_COLUMNS, BENCH_ROWS);
+    benchGuiManager(gui, lcd, out);
+    benchLvgl(lvgl, lcd, out);
+}
+
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+#if defined(UNIMIX_RENDER_BENCH) && defined(UNIMIX_USE_LVGL)
+
+#include "../GUI/GuiManager.hpp"
+#include "../lvgl/LvglBackend.hpp"
+
+#define BENCH_FRAMES 200
+#define BENCH_COLUMNS 4
+#define BENCH_ROWS 3
+
+// Renders the same button grid through GuiManager and through LVGL, toggles one
+// button per frame, and prints frame time statistics for both to out
+void runRenderBench(GuiManager& gui, LvglBackend& lvgl, LGFX& lcd, Print& out);
+
+#endif
@@ -0,0 +1,102 @@
+#include "CommLink.hpp"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "../diag/MemoryTags.hpp"
+
+CommLink::CommLink(Transport& transport, InboxQueue& inbox, OutboxQueue& outbox)
+    : m_transport(transport), m_inbox(inbox), m_outbox(outbox), m_dropped(0), m_bulk(), m_bulkCount(0), m_bulkCredit(0) {
+    // Fixed size, reported so the protocol's share of RAM is in the totals
+    memAlloc(MemTag::Protocol, sizeof(InboxQueue) + sizeof(OutboxQueue));
+}
+
+#ifdef ARDUINO
+void CommLink::start(BaseType_t core) {
+    m_transport.begin();
+    xTaskCreatePinnedToCore(CommLink::taskEntry, "comm_link", COMM_LINK_STACK, this, COMM_LINK_PRIORITY, &m_task, core);
+}
+
+TaskHandle_t CommLink::getTask() const {
+    return m_task;
+}
+
+void CommLink::taskEntry(void* arg) {
+    CommLink* link = static_cast<CommLink*>(arg);
+    for (;;) {
+        link->poll();
+        vTaskDelay(pdMS_TO_TICKS(COMM_LINK_POLL_MS));
+    }
+}
+#endif
+
+void CommLink::poll() {
+    receive();
+    transmit();
+    transmitBulk();
+}
+
+bool CommLink::addBulkQueue(BulkQueue* bulk) {
+    if (m_bulkCount >= COMM_BULK_QUEUES) {
+        return false;
+    }
+    m_bulk[m_bulkCount++] = bulk;
+    return true;
+}
+
+Transport& CommLink::getTransport() {
+    return m_transport;
+}
+
+uint32_t CommLink::getDroppedCount() const {
+    return m_dropped;
+}
+
+void CommLink::receive() {
+    uint8_t frame[sizeof(MixerMessage)];
+    size_t length;
+
+    // Leave frames in the transport while the UI is behind instead of dropping them
+    while (m_inbox.size() < InboxQueue::capacity() && (length = m_transport.recv(frame, sizeof(frame))) > 0) {
+        if (length != sizeof(MixerMessage)) {
+            m_dropped++;
+            continue;
+        }
+
+        MixerMessage message;
+        memcpy(&message, frame, sizeof(message));
+        m_inbox.push(message);
+    }
+}
+
+void CommLink::transmit() {
+    MixerMessage message;
+    while (m_outbox.pop(message)) {
+        if (!m_transport.send(reinterpret_cast<const uint8_t*>(&message), sizeof(message))) {
+            m_dropped++;
+        }
+    }
+}
+
+void CommLink::transmitBulk() {
+    if (m_bulkCount == 0) {
+        return;
+    }
+
+    // At most one frame per refill, so the mixer messages of the next poll never wait behind a burst
+    m_bulkCredit = std::min<uint32_t>(m_bulkCredit + BULK_BYTES_PER_POLL, BULK_FRAME_BYTES);
+    if (m_bulkCredit < BULK_FRAME_BYTES) {
+        return;
+    }
+    BulkFrame frame;
+    for (uint8_t i = 0; i < m_bulkCount; i++) {
+        if (m_bulk[i]->pop(frame)) {
+            m_bulkCredit -= frame.length;
+            if (!m_transport.send(frame.data, frame.length)) {
+                m_dropped++;
+            }
+            return;
+        }
+    }
+}
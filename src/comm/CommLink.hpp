@@ -0,0 +1,56 @@
+#pragma once
+#include "Transport.hpp"
+#include "messages.hpp"
+
+#ifdef ARDUINO
+#include "Arduino.h"
+#endif
+
+#define COMM_LINK_STACK 3072
+#define COMM_LINK_PRIORITY 2
+#define COMM_LINK_POLL_MS 2
+
+// Bulk frames get this many bytes of credit per poll, ~4 KB/s at the poll
+// rate, a third of a 115200 baud link. Unused credit is kept up to one frame.
+#define BULK_BYTES_PER_POLL 8
+#define COMM_BULK_QUEUES 3
+
+// Moves MixerMessages between a Transport and the UI queues on its own task,
+// so waiting on the host never blocks the render loop. Each frame carries one
+// raw MixerMessage.
+class CommLink {
+   public:
+    CommLink(Transport& transport, InboxQueue& inbox, OutboxQueue& outbox);
+
+#ifdef ARDUINO
+    void start(BaseType_t core = 0);
+    TaskHandle_t getTask() const;
+#endif
+
+    // One receive/transmit pass; the task calls it in a loop, native tools call it directly
+    void poll();
+
+    // Optional low-priority streams, sent after the mixer messages and rate
+    // limited together. Earlier queues go first. One producer per queue.
+    bool addBulkQueue(BulkQueue* bulk);
+
+    Transport& getTransport();
+    uint32_t getDroppedCount() const;
+
+   private:
+    Transport& m_transport;
+    InboxQueue& m_inbox;
+    OutboxQueue& m_outbox;
+    uint32_t m_dropped;
+    BulkQueue* m_bulk[COMM_BULK_QUEUES];
+    uint8_t m_bulkCount;
+    uint32_t m_bulkCredit;
+
+#ifdef ARDUINO
+    TaskHandle_t m_task = nullptr;
+    static void taskEntry(void* arg);
+#endif
+    void receive();
+    void transmit();
+    void transmitBulk();
+};
@@ -0,0 +1,35 @@
+#include "FramePrint.hpp"
+
+FramePrint::FramePrint(BulkQueue& queue, uint32_t waitMs) : m_queue(queue), m_waitMs(waitMs), m_dropped(0) {
+    m_frame.length = 0;
+}
+
+size_t FramePrint::write(uint8_t byte) {
+    if (m_frame.length == 0) {
+        m_frame.data[m_frame.length++] = TEXT_FRAME_TAG;
+    }
+    m_frame.data[m_frame.length++] = byte;
+    if (byte == '\n' || m_frame.length == BULK_FRAME_BYTES) {
+        sendPending();
+    }
+    return 1;
+}
+
+void FramePrint::sendPending() {
+    if (m_frame.length == 0) {
+        return;
+    }
+    uint32_t waited = 0;
+    while (!m_queue.push(m_frame)) {
+        if (waited++ >= m_waitMs) {
+            m_dropped++;
+            break;
+        }
+        delay(1);
+    }
+    m_frame.length = 0;
+}
+
+uint32_t FramePrint::getDroppedCount() const {
+    return m_dropped;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+
+#include "Arduino.h"
+#include "messages.hpp"
+
+// Text written as TEXT_FRAME_TAG bulk frames, so the comm task stays the only
+// writer on a port that also carries the mixer protocol. A frame is queued at
+// each newline or when full. One writing task per instance, like its queue.
+class FramePrint : public Print {
+   public:
+    // waitMs: how long a write may wait for room in the queue before the frame is dropped
+    FramePrint(BulkQueue& queue, uint32_t waitMs = 0);
+
+    size_t write(uint8_t byte) override;
+    using Print::write;
+
+    // Queues a partly filled frame
+    void sendPending();
+
+    uint32_t getDroppedCount() const;
+
+   private:
+    BulkQueue& m_queue;
+    uint32_t m_waitMs;
+    BulkFrame m_frame;
+    uint32_t m_dropped;
+};
@@ -0,0 +1,60 @@
+#include "LoopbackTransport.hpp"
+
+#include <string.h>
+
+#ifdef ARDUINO
+#include "Arduino.h"
+#else
+#include <chrono>
+static uint32_t millis() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+LoopbackTransport::LoopbackTransport(LoopbackChannel& tx, LoopbackChannel& rx) : m_tx(tx), m_rx(rx) {
+}
+
+bool LoopbackTransport::begin() {
+    return true;
+}
+
+bool LoopbackTransport::isConnected() const {
+    return true;
+}
+
+size_t LoopbackTransport::mtu() const {
+    return LOOPBACK_MTU;
+}
+
+bool LoopbackTransport::send(const uint8_t* frame, size_t length) {
+    if (length == 0 || length > LOOPBACK_MTU) {
+        m_quality.errors++;
+        return false;
+    }
+
+    LoopbackFrame slot;
+    slot.length = (uint16_t)length;
+    memcpy(slot.data, frame, length);
+    if (!m_tx.push(slot)) {
+        m_quality.errors++;  // Peer is not draining fast enough
+        return false;
+    }
+    m_quality.framesSent++;
+    return true;
+}
+
+size_t LoopbackTransport::recv(uint8_t* buffer, size_t capacity) {
+    LoopbackFrame slot;
+    if (!m_rx.pop(slot)) {
+        return 0;
+    }
+    if (slot.length > capacity) {
+        m_quality.errors++;
+        return 0;
+    }
+    memcpy(buffer, slot.data, slot.length);
+    m_quality.framesReceived++;
+    m_quality.lastRxMs = millis();
+    return slot.length;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "Transport.hpp"
+#include "spsc_queue.hpp"
+
+#define LOOPBACK_MTU 256
+#define LOOPBACK_DEPTH 64
+
+struct LoopbackFrame {
+    uint16_t length;
+    uint8_t data[LOOPBACK_MTU];
+};
+
+using LoopbackChannel = SpscQueue<LoopbackFrame, LOOPBACK_DEPTH>;
+
+// In-process link, portable C++ so the stack above it can be exercised on a
+// Linux host (env:native) as well as on the device. Each direction is one SPSC
+// channel, so the two ends may live on different threads.
+class LoopbackTransport : public Transport {
+   public:
+    LoopbackTransport(LoopbackChannel& tx, LoopbackChannel& rx);
+
+    bool begin() override;
+    bool isConnected() const override;
+    size_t mtu() const override;
+    bool send(const uint8_t* frame, size_t length) override;
+    size_t recv(uint8_t* buffer, size_t capacity) override;
+
+   private:
+    LoopbackChannel& m_tx;
+    LoopbackChannel& m_rx;
+};
+
+// Both ends of a loopback link
+struct LoopbackPair {
+    LoopbackChannel toHost;
+    LoopbackChannel toDevice;
+    LoopbackTransport device{toHost, toDevice};
+    LoopbackTransport host{toDevice, toHost};
+};
@@ -0,0 +1,90 @@
+#ifdef ARDUINO
+#include "SerialTransport.hpp"
+
+#include <string.h>
+
+SerialTransport::SerialTransport(Stream& port)
+    : m_port(port), m_state(RxState::Sync), m_length(0), m_received(0), m_checksum(0) {
+}
+
+bool SerialTransport::begin() {
+    return true;  // The port is opened by Serial.begin() in setup()
+}
+
+bool SerialTransport::isConnected() const {
+    return true;
+}
+
+size_t SerialTransport::mtu() const {
+    return SERIAL_TRANSPORT_MTU;
+}
+
+bool SerialTransport::send(const uint8_t* frame, size_t length) {
+    if (length == 0 || length > SERIAL_TRANSPORT_MTU) {
+        m_quality.errors++;
+        return false;
+    }
+
+    uint8_t checksum = 0;
+    for (size_t i = 0; i < length; i++) {
+        checksum += frame[i];
+    }
+
+    m_port.write((uint8_t)SERIAL_FRAME_SYNC);
+    m_port.write((uint8_t)length);
+    m_port.write(frame, length);
+    m_port.write(checksum);
+    m_quality.framesSent++;
+    return true;
+}
+
+size_t SerialTransport::recv(uint8_t* buffer, size_t capacity) {
+    while (m_port.available() > 0) {
+        int value = m_port.read();
+        if (value < 0) {
+            break;
+        }
+        uint8_t byte = (uint8_t)value;
+
+        switch (m_state) {
+            case RxState::Sync:
+                if (byte == SERIAL_FRAME_SYNC) {
+                    m_state = RxState::Length;
+                } else if (onStrayByte) {
+                    onStrayByte(byte);
+                }
+                break;
+            case RxState::Length:
+                if (byte == 0 || byte > SERIAL_TRANSPORT_MTU) {
+                    m_quality.errors++;
+                    m_state = RxState::Sync;
+                    break;
+                }
+                m_length = byte;
+                m_received = 0;
+                m_checksum = 0;
+                m_state = RxState::Payload;
+                break;
+            case RxState::Payload:
+                m_frame[m_received++] = byte;
+                m_checksum += byte;
+                if (m_received == m_length) {
+                    m_state = RxState::Checksum;
+                }
+                break;
+            case RxState::Checksum:
+                m_state = RxState::Sync;
+                if (byte != m_checksum || m_length > capacity) {
+                    m_quality.errors++;
+                    break;
+                }
+                memcpy(buffer, m_frame, m_length);
+                m_quality.framesReceived++;
+                m_quality.lastRxMs = millis();
+                return m_length;
+        }
+    }
+    return 0;
+}
+
+#endif
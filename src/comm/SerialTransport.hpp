@@ -0,0 +1,37 @@
+#pragma once
+#ifdef ARDUINO
+#include "Arduino.h"
+#include "Transport.hpp"
+#include "../delegate.hpp"
+
+#define SERIAL_FRAME_SYNC 0xA5
+#define SERIAL_TRANSPORT_MTU 64
+
+// Frames over a byte stream: SYNC, length, payload, 8-bit checksum.
+// A bad checksum or length drops the frame and hunts for the next SYNC.
+class SerialTransport : public Transport {
+   public:
+    SerialTransport(Stream& port);
+
+    bool begin() override;
+    bool isConnected() const override;
+    size_t mtu() const override;
+    bool send(const uint8_t* frame, size_t length) override;
+    size_t recv(uint8_t* buffer, size_t capacity) override;
+
+    // Bytes outside any frame, such as commands typed into the serial monitor.
+    // Called from the task that polls the transport.
+    Delegate<void(uint8_t)> onStrayByte;
+
+   private:
+    enum class RxState : uint8_t { Sync, Length, Payload, Checksum };
+
+    Stream& m_port;
+    RxState m_state;
+    uint8_t m_frame[SERIAL_TRANSPORT_MTU];
+    uint8_t m_length;
+    uint8_t m_received;
+    uint8_t m_checksum;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+struct LinkQuality {
+    uint32_t framesSent;
+    uint32_t framesReceived;
+    uint32_t errors;      // Corrupt, oversized or undeliverable frames
+    uint32_t lastRxMs;    // Time of the last good frame
+    int16_t rssi;         // dBm for radio links, 0 otherwise
+};
+
+// Frame-oriented link under the mixer protocol. send() and recv() move whole
+// frames of at most mtu() bytes and never block; each implementation does its
+// own framing (SYNC byte, length and checksum on serial, one datagram per frame
+// on UDP).
+class Transport {
+   public:
+    virtual ~Transport() = default;
+
+    virtual bool begin() = 0;
+    virtual bool isConnected() const = 0;
+    virtual size_t mtu() const = 0;
+
+    virtual bool send(const uint8_t* frame, size_t length) = 0;
+
+    // Length of the received frame, 0 when none is pending
+    virtual size_t recv(uint8_t* buffer, size_t capacity) = 0;
+
+    // Whether frames still arrive while the CPU light-sleeps; UART receive loses bytes then
+    virtual bool allowsLightSleep() const {
+        return false;
+    }
+
+    // Nobody is looking at the screen, the link may trade latency for power
+    virtual void setPowerSave(bool) {
+    }
+
+    const LinkQuality& linkQuality() const {
+        return m_quality;
+    }
+
+   protected:
+    LinkQuality m_quality = {0, 0, 0, 0, 0};
+};
@@ -0,0 +1,73 @@
+#ifdef ARDUINO
+#include "UdpTransport.hpp"
+
+UdpTransport::UdpTransport(const char* ssid, const char* password, uint16_t port)
+    : m_ssid(ssid), m_password(password), m_port(port), m_hostPort(0), m_hasHost(false), m_powerSave(false) {
+}
+
+bool UdpTransport::begin() {
+    WiFi.mode(WIFI_STA);
+    WiFi.setSleep(false);  // Modem sleep adds up to a beacon interval of latency per packet, see setPowerSave()
+    WiFi.setAutoReconnect(true);
+    WiFi.begin(m_ssid, m_password);
+    return m_udp.begin(m_port) == 1;
+}
+
+void UdpTransport::setPowerSave(bool enabled) {
+    if (enabled == m_powerSave) {
+        return;
+    }
+    // Only while the panel is blank, when a slow host update costs nothing
+    WiFi.setSleep(enabled ? WIFI_PS_MIN_MODEM : WIFI_PS_NONE);
+    m_powerSave = enabled;
+}
+
+bool UdpTransport::isConnected() const {
+    return WiFi.status() == WL_CONNECTED && m_hasHost;
+}
+
+size_t UdpTransport::mtu() const {
+    return UDP_TRANSPORT_MTU;
+}
+
+bool UdpTransport::send(const uint8_t* frame, size_t length) {
+    if (!m_hasHost || WiFi.status() != WL_CONNECTED || length > UDP_TRANSPORT_MTU) {
+        m_quality.errors++;
+        return false;
+    }
+
+    m_udp.beginPacket(m_host, m_hostPort);
+    m_udp.write(frame, length);
+    if (m_udp.endPacket() != 1) {
+        m_quality.errors++;
+        return false;
+    }
+    m_quality.framesSent++;
+    return true;
+}
+
+size_t UdpTransport::recv(uint8_t* buffer, size_t capacity) {
+    int size = m_udp.parsePacket();
+    if (size <= 0) {
+        return 0;
+    }
+
+    if ((size_t)size > capacity) {
+        m_udp.flush();
+        m_quality.errors++;
+        return 0;
+    }
+
+    // Reply to whoever talked to us last
+    m_host = m_udp.remoteIP();
+    m_hostPort = m_udp.remotePort();
+    m_hasHost = true;
+
+    int length = m_udp.read(buffer, capacity);
+    m_quality.framesReceived++;
+    m_quality.lastRxMs = millis();
+    m_quality.rssi = WiFi.RSSI();
+    return length > 0 ? (size_t)length : 0;
+}
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+#ifdef ARDUINO
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#include "Transport.hpp"
+
+#define UDP_TRANSPORT_MTU 512
+#define UDP_TRANSPORT_PORT 4210
+
+// One datagram per frame over Wi-Fi. The host is learned from the first
+// datagram received, so the device only needs the network credentials.
+class UdpTransport : public Transport {
+   public:
+    UdpTransport(const char* ssid, const char* password, uint16_t port = UDP_TRANSPORT_PORT);
+
+    bool begin() override;
+    bool isConnected() const override;
+    size_t mtu() const override;
+    bool send(const uint8_t* frame, size_t length) override;
+    size_t recv(uint8_t* buffer, size_t capacity) override;
+
+    // Automatic light sleep needs modem sleep, which setPowerSave(true) turns on.
+    // The station then stays associated, waking for beacons.
+    bool allowsLightSleep() const override {
+        return m_powerSave;
+    }
+    void setPowerSave(bool enabled) override;
+
+   private:
+    const char* m_ssid;
+    const char* m_password;
+    uint16_t m_port;
+    WiFiUDP m_udp;
+    IPAddress m_host;
+    uint16_t m_hostPort;
+    bool m_hasHost;
+    bool m_powerSave;
+};
+
+#endif
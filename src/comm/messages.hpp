@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+
+#include "spsc_queue.hpp"
+
+#define MESSAGE_TEXT_LEN 24
+
+enum class MessageType : uint8_t {
+    None = 0,
+    // Host -> UI
+    SessionAdded,
+    SessionRemoved,
+    SessionVolume,
+    SessionMute,
+    SessionName,
+    SnapshotBegin,  // Full state follows as SessionAdded messages, all with the same sequence
+    SnapshotEnd,
+    // UI -> host
+    SetVolume,
+    SetMute,
+    Ack,            // sequence = last applied model version
+    ResyncRequest,  // Ask for a snapshot, sent on connect and after a gap
+    SetSessions,    // Several sessions at once (presets): session = bit per session included,
+                    // value = bit per muted session, text[i] = volume of session i
+    // Host -> UI, "now playing" artwork, not part of the model
+    ArtBegin,  // value = ArtFormat, sequence = image size in bytes
+    ArtChunk,  // sequence = offset, value = byte count (up to MESSAGE_TEXT_LEN) in text
+    ArtEnd,    // sequence = image size, the image is complete
+};
+
+// Fixed-size slot shared by both directions so queues never allocate
+struct MixerMessage {
+    MessageType type;
+    uint8_t session;
+    int16_t value;
+    uint32_t sequence;  // Model version, host -> UI state messages only
+    char text[MESSAGE_TEXT_LEN];
+};
+
+using InboxQueue = SpscQueue<MixerMessage, 32>;   // Host -> UI model updates
+using OutboxQueue = SpscQueue<MixerMessage, 16>;  // UI -> host events
+
+// Low-priority frames (screen mirroring, text), sent whole with whatever bandwidth
+// the mixer protocol leaves. The first byte is a tag >= 0x80 so the host can tell
+// them from MixerMessages, whose first byte is a MessageType.
+#define BULK_FRAME_BYTES 60
+#define TEXT_FRAME_TAG 0xF1  // Log lines and console replies, the tag then text (src/comm/FramePrint.hpp)
+
+struct BulkFrame {
+    uint8_t length;
+    uint8_t data[BULK_FRAME_BYTES];
+};
+
+using BulkQueue = SpscQueue<BulkFrame, 32>;  // UI -> host
@@ -0,0 +1,60 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+// Lock-free single-producer/single-consumer ring of fixed-size slots.
+// Exactly one task may push and exactly one task may pop. The producer
+// publishes a slot with a release store of m_head, the consumer frees it with
+// a release store of m_tail; each side reads the other's index with acquire,
+// which orders the slot contents correctly across both ESP32 cores.
+template <typename T, size_t Size>
+class SpscQueue {
+    static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "SpscQueue size must be a power of two");
+
+   public:
+    SpscQueue() : m_head(0), m_tail(0) {}
+
+    // Producer side
+    bool push(const T& item) {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        uint32_t tail = m_tail.load(std::memory_order_acquire);
+        if (head - tail >= Size) {
+            return false;  // Full
+        }
+        m_slots[head & (Size - 1)] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t head = m_head.load(std::memory_order_acquire);
+        if (head == tail) {
+            return false;  // Empty
+        }
+        item = m_slots[tail & (Size - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called from either side while the other is active
+    size_t size() const {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    static constexpr size_t capacity() {
+        return Size;
+    }
+
+   private:
+    T m_slots[Size];
+    std::atomic<uint32_t> m_head;  // Written by the producer only
+    std::atomic<uint32_t> m_tail;  // Written by the consumer only
+};
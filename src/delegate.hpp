@@ -0,0 +1,103 @@
+#pragma once
+#include <stddef.h>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Callable with small-buffer storage. The callable (a function pointer, a
+// capturing lambda, a bound member function) is kept inline, so assigning a
+// handler never touches the heap. Anything larger than Capacity fails to compile.
+template <typename Signature, size_t Capacity = 3 * sizeof(void*)>
+class Delegate;
+
+template <typename R, typename... Args, size_t Capacity>
+class Delegate<R(Args...), Capacity> {
+   public:
+    Delegate() : m_invoke(nullptr), m_manage(nullptr) {}
+    Delegate(std::nullptr_t) : Delegate() {}
+
+    template <typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, Delegate>::value>::type>
+    Delegate(F&& callable) : Delegate() {
+        assign(std::forward<F>(callable));
+    }
+
+    Delegate(const Delegate& other) : Delegate() {
+        copyFrom(other);
+    }
+
+    Delegate& operator=(const Delegate& other) {
+        if (this != &other) {
+            reset();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    Delegate& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    ~Delegate() {
+        reset();
+    }
+
+    // Call a member function on a specific object, e.g. Delegate<void()>::bind<Strip, &Strip::mute>(strip)
+    template <typename T, R (T::*Method)(Args...)>
+    static Delegate bind(T* object) {
+        return Delegate([object](Args... args) { return (object->*Method)(std::forward<Args>(args)...); });
+    }
+
+    explicit operator bool() const {
+        return m_invoke != nullptr;
+    }
+
+    R operator()(Args... args) const {
+        return m_invoke(&m_storage, std::forward<Args>(args)...);
+    }
+
+    void reset() {
+        if (m_manage != nullptr) {
+            m_manage(&m_storage, nullptr);
+        }
+        m_invoke = nullptr;
+        m_manage = nullptr;
+    }
+
+   private:
+    using Storage = typename std::aligned_storage<Capacity, alignof(void*)>::type;
+    using Invoker = R (*)(const void*, Args&&...);
+    using Manager = void (*)(void* self, const void* copySource);  // copySource == nullptr means destroy
+
+    Storage m_storage;
+    Invoker m_invoke;
+    Manager m_manage;
+
+    template <typename F>
+    void assign(F&& callable) {
+        using Callable = typename std::decay<F>::type;
+        static_assert(sizeof(Callable) <= Capacity, "Delegate: callable does not fit the inline buffer");
+        static_assert(alignof(Callable) <= alignof(Storage), "Delegate: callable is over-aligned");
+
+        new (&m_storage) Callable(std::forward<F>(callable));
+        m_invoke = [](const void* storage, Args&&... args) -> R {
+            return (*const_cast<Callable*>(static_cast<const Callable*>(storage)))(std::forward<Args>(args)...);
+        };
+        m_manage = [](void* self, const void* copySource) {
+            if (copySource != nullptr) {
+                new (self) Callable(*static_cast<const Callable*>(copySource));
+            } else {
+                static_cast<Callable*>(self)->~Callable();
+            }
+        };
+    }
+
+    void copyFrom(const Delegate& other) {
+        if (other.m_manage != nullptr) {
+            other.m_manage(&m_storage, &other.m_storage);
+        }
+        m_invoke = other.m_invoke;
+        m_manage = other.m_manage;
+    }
+};
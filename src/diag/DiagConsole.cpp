@@ -0,0 +1,53 @@
+#include "DiagConsole.hpp"
+
+#include <string.h>
+
+DiagConsole::DiagConsole() : m_commandCount(0), m_length(0), m_ready(false) {
+    m_line[0] = '\0';
+    m_pending[0] = '\0';
+}
+
+bool DiagConsole::addCommand(const char* name, const char* help, DiagHandler handler) {
+    if (m_commandCount >= DIAG_MAX_COMMANDS) {
+        return false;
+    }
+    m_commands[m_commandCount++] = {name, help, handler};
+    return true;
+}
+
+void DiagConsole::feed(uint8_t byte) {
+    if (byte == '\r' || byte == '\n') {
+        if (m_length > 0 && !m_ready.load(std::memory_order_acquire)) {
+            memcpy(m_pending, m_line, m_length);
+            m_pending[m_length] = '\0';
+            m_ready.store(true, std::memory_order_release);
+        }
+        m_length = 0;
+        return;
+    }
+
+    // Printable text only, anything else is line noise or a broken frame
+    if (byte >= 0x20 && byte < 0x7F && m_length < DIAG_LINE_MAX - 1) {
+        m_line[m_length++] = (char)byte;
+    }
+}
+
+void DiagConsole::poll(Print& out) {
+    if (!m_ready.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < m_commandCount; i++) {
+        if (strcmp(m_pending, m_commands[i].name) == 0) {
+            m_commands[i].handler(out);
+            m_ready.store(false, std::memory_order_release);
+            return;
+        }
+    }
+
+    out.printf("[diag] unknown command '%s', commands:\n", m_pending);
+    for (uint8_t i = 0; i < m_commandCount; i++) {
+        out.printf("[diag]   %-6s %s\n", m_commands[i].name, m_commands[i].help);
+    }
+    m_ready.store(false, std::memory_order_release);
+}
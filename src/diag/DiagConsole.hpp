@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+
+#include <atomic>
+
+#include "Arduino.h"
+#include "../delegate.hpp"
+
+#define DIAG_LINE_MAX 32
+#define DIAG_MAX_COMMANDS 16
+
+using DiagHandler = Delegate<void(Print&)>;
+
+// Line-based diagnostic commands typed into the serial monitor ("mem", "cpu").
+// Bytes may be fed from another task (the comm task hands over whatever is
+// not part of a protocol frame); commands run from poll() in the UI loop.
+// Replies go to poll()'s Print, which must not write to a port shared with
+// the mixer protocol from this task (main uses a FramePrint there).
+class DiagConsole {
+   public:
+    DiagConsole();
+
+    bool addCommand(const char* name, const char* help, DiagHandler handler);
+
+    // One feeding task at a time; a line arriving while the last one is unhandled is dropped
+    void feed(uint8_t byte);
+
+    void poll(Print& out);
+
+   private:
+    struct Command {
+        const char* name;
+        const char* help;
+        DiagHandler handler;
+    };
+
+    Command m_commands[DIAG_MAX_COMMANDS];
+    uint8_t m_commandCount;
+    char m_line[DIAG_LINE_MAX];
+    uint8_t m_length;
+    char m_pending[DIAG_LINE_MAX];
+    std::atomic<bool> m_ready;
+};
@@ -0,0 +1,200 @@
+#include "FrameWatchdog.hpp"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../GUI/component.hpp"
+#include "../log/Log.hpp"
+
+#ifdef ARDUINO
+#include <esp_attr.h>
+#include <esp_system.h>
+#else
+#define RTC_NOINIT_ATTR
+#endif
+
+#define JANK_LOG_MAGIC 0x4A4E4B32     // "JNK2"
+#define BREADCRUMB_MAGIC 0x46524D31  // "FRM1", set only while a frame is open
+
+// Survives soft resets; magic and checksum tell a valid ring from power-on garbage
+struct JankLog {
+    uint32_t magic;
+    uint32_t boot;
+    uint32_t lastResetReason;
+    uint32_t head;
+    uint32_t count;
+    JankRecord records[JANK_RECORDS];
+    uint32_t checksum;
+};
+
+// The frame being timed, written as it goes so a reset mid-frame leaves it behind
+struct FrameBreadcrumb {
+    uint32_t magic;
+    uint8_t phase;  // The phase after the last one marked
+    uint16_t componentId;  // Component inside draw(), 0 between draws
+    JankRecord frame;
+};
+
+RTC_NOINIT_ATTR static JankLog s_log;
+RTC_NOINIT_ATTR static FrameBreadcrumb s_breadcrumb;
+static FrameWatchdog* s_current = nullptr;
+
+static const char* const PHASE_NAMES[] = {"msg", "anim", "draw", "touch-read", "touch"};
+
+static uint32_t checksumOf(const JankLog& log) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&log);
+    uint32_t sum = 2166136261u;
+    for (size_t i = 0; i < offsetof(JankLog, checksum); i++) {
+        sum = (sum ^ bytes[i]) * 16777619u;
+    }
+    return sum;
+}
+
+static void storeRecord(const JankRecord& record) {
+    s_log.records[s_log.head] = record;
+    s_log.head = (s_log.head + 1) % JANK_RECORDS;
+    if (s_log.count < JANK_RECORDS) {
+        s_log.count++;
+    }
+    s_log.checksum = checksumOf(s_log);
+}
+
+FrameWatchdog::FrameWatchdog(uint32_t budgetUs) : m_budgetUs(budgetUs), m_frameStartUs(0), m_markUs(0), m_jankCount(0) {
+}
+
+void FrameWatchdog::begin() {
+    if (s_log.magic != JANK_LOG_MAGIC || s_log.checksum != checksumOf(s_log) || s_log.head >= JANK_RECORDS || s_log.count > JANK_RECORDS) {
+        memset(&s_log, 0, sizeof(s_log));
+        s_log.magic = JANK_LOG_MAGIC;
+    }
+
+    // A frame still open from the boot before never reached endFrame()
+    JankRecord& open = s_breadcrumb.frame;
+    if (s_breadcrumb.magic == BREADCRUMB_MAGIC && open.boot == s_log.boot && s_breadcrumb.phase < static_cast<uint8_t>(FramePhase::Count)) {
+        open.frameUs = 0;
+        for (uint32_t us : open.phaseUs) {
+            open.frameUs += us;  // Up to the last mark, the hang itself is not counted
+        }
+        open.hungPhase = s_breadcrumb.phase;
+        open.hungComponentId = s_breadcrumb.componentId;
+        storeRecord(open);
+    }
+    s_breadcrumb.magic = 0;
+
+    s_log.boot++;
+#ifdef ARDUINO
+    s_log.lastResetReason = esp_reset_reason();
+#endif
+    s_log.checksum = checksumOf(s_log);
+}
+
+void FrameWatchdog::setBudgetUs(uint32_t budgetUs) {
+    m_budgetUs = budgetUs;
+}
+
+uint32_t FrameWatchdog::getBudgetUs() const {
+    return m_budgetUs;
+}
+
+FrameWatchdog* FrameWatchdog::current() {
+    return s_current;
+}
+
+void FrameWatchdog::beginFrame() {
+    memset(&s_breadcrumb, 0, sizeof(s_breadcrumb));
+    s_breadcrumb.frame.boot = s_log.boot;
+    s_breadcrumb.frame.uptimeMs = millis();
+    s_breadcrumb.frame.hungPhase = static_cast<uint8_t>(FramePhase::Count);
+    s_breadcrumb.magic = BREADCRUMB_MAGIC;
+    m_frameStartUs = micros();
+    m_markUs = m_frameStartUs;
+    s_current = this;
+}
+
+void FrameWatchdog::mark(FramePhase phase) {
+    uint32_t now = micros();
+    s_breadcrumb.frame.phaseUs[static_cast<uint8_t>(phase)] += now - m_markUs;
+    s_breadcrumb.phase = static_cast<uint8_t>(phase) + 1;
+    m_markUs = now;
+}
+
+void FrameWatchdog::componentStarted(const Component& component) {
+    s_breadcrumb.phase = static_cast<uint8_t>(FramePhase::Draw);
+    s_breadcrumb.componentId = component.id;
+}
+
+void FrameWatchdog::componentDrawn(const Component& component, uint32_t us) {
+    s_breadcrumb.componentId = 0;
+
+    // Insertion into the short longest-first list
+    JankRecord& frame = s_breadcrumb.frame;
+    for (int i = 0; i < JANK_SLOWEST; i++) {
+        JankDraw& slot = frame.slowest[i];
+        if (slot.componentId == 0 || us > slot.us) {
+            memmove(&frame.slowest[i + 1], &frame.slowest[i], (JANK_SLOWEST - 1 - i) * sizeof(JankDraw));
+            const Rectangle& region = component.bounds;
+            slot = {component.id, (int16_t)region.origin.x, (int16_t)region.origin.y, (int16_t)region.w, (int16_t)region.h, us};
+            return;
+        }
+    }
+}
+
+void FrameWatchdog::endFrame() {
+    s_current = nullptr;
+    s_breadcrumb.magic = 0;
+    JankRecord& frame = s_breadcrumb.frame;
+    frame.frameUs = micros() - m_frameStartUs;
+    if (frame.frameUs <= m_budgetUs) {
+        return;
+    }
+
+    m_jankCount++;
+    storeRecord(frame);
+
+    const JankDraw& worst = frame.slowest[0];
+    LOG_W("jank: frame %u us, draw %u us, worst component #%u %u us", frame.frameUs, frame.phaseUs[static_cast<uint8_t>(FramePhase::Draw)],
+          worst.componentId, worst.us);
+}
+
+uint32_t FrameWatchdog::getJankCount() const {
+    return m_jankCount;
+}
+
+size_t FrameWatchdog::getRecordCount() const {
+    return s_log.count;
+}
+
+const JankRecord& FrameWatchdog::getRecord(size_t index) const {
+    return s_log.records[(s_log.head + JANK_RECORDS - s_log.count + index) % JANK_RECORDS];
+}
+
+void FrameWatchdog::clear() {
+    s_log.head = 0;
+    s_log.count = 0;
+    s_log.checksum = checksumOf(s_log);
+}
+
+void FrameWatchdog::report(Print& out) const {
+    out.printf("[jank] budget %u us, %u janky frames this boot, boot %u (reset reason %u)\n", m_budgetUs, m_jankCount, s_log.boot,
+               s_log.lastResetReason);
+    for (size_t i = 0; i < getRecordCount(); i++) {
+        const JankRecord& record = getRecord(i);
+        out.printf("[jank] boot %u at %u ms: frame %u us (", record.boot, record.uptimeMs, record.frameUs);
+        for (uint8_t phase = 0; phase < static_cast<uint8_t>(FramePhase::Count); phase++) {
+            out.printf("%s%s %u", phase > 0 ? ", " : "", PHASE_NAMES[phase], record.phaseUs[phase]);
+        }
+        out.println(")");
+        if (record.hungPhase < static_cast<uint8_t>(FramePhase::Count)) {
+            out.printf("[jank]   never ended: reset during %s", PHASE_NAMES[record.hungPhase]);
+            if (record.hungComponentId != 0) {
+                out.printf(", inside component #%u", record.hungComponentId);
+            }
+            out.println();
+        }
+        for (const auto& draw : record.slowest) {
+            if (draw.componentId != 0) {
+                out.printf("[jank]   component #%u at %d,%d %dx%d: %u us\n", draw.componentId, draw.x, draw.y, draw.w, draw.h, draw.us);
+            }
+        }
+    }
+}
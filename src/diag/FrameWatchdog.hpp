@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+
+#include "Arduino.h"
+#include "../utils.hpp"
+
+#define FRAME_BUDGET_US 50000
+#define JANK_RECORDS 16
+#define JANK_SLOWEST 3  // Component draws kept per janky frame
+
+enum class FramePhase : uint8_t {
+    Messages,       // Draining and applying host updates
+    Animation,
+    Draw,
+    TouchRead,      // The touch controller transaction
+    TouchDispatch,  // Hit testing and click handlers
+    Count
+};
+
+struct JankDraw {
+    uint16_t componentId;
+    int16_t x, y, w, h;  // Screen region drawn
+    uint32_t us;
+};
+
+struct JankRecord {
+    uint32_t boot;
+    uint32_t uptimeMs;
+    uint32_t frameUs;
+    uint32_t phaseUs[static_cast<uint8_t>(FramePhase::Count)];
+    JankDraw slowest[JANK_SLOWEST];  // Longest first, componentId 0 marks unused
+    uint16_t hungComponentId;        // Component drawing when the frame never ended, 0 for none
+    uint8_t hungPhase;               // Phase the frame never left before a reset, Count for frames that ended
+};
+
+class Component;
+
+// Times every GuiManager frame by phase and by component draw. A frame over
+// budget is stored in a ring in RTC memory that is not initialized on a soft
+// reset ("jank" on the serial console). Power loss clears it.
+//
+// The frame being timed also lives in RTC memory, with the phase and the
+// component in progress. A frame that never ends because a hang ended in a
+// watchdog reset is found there by begin() and stored as a record that names
+// where it stopped.
+class FrameWatchdog {
+   public:
+    FrameWatchdog(uint32_t budgetUs = FRAME_BUDGET_US);
+
+    // Validates the persistent ring, stores a frame the last reset cut short and counts this boot
+    void begin();
+
+    void setBudgetUs(uint32_t budgetUs);
+    uint32_t getBudgetUs() const;
+
+    // Called by GuiManager around and within update()
+    void beginFrame();
+    void mark(FramePhase phase);  // Time since the last mark goes to phase
+    void endFrame();
+
+    // Called around each component draw while a frame is being timed
+    void componentStarted(const Component& component);
+    void componentDrawn(const Component& component, uint32_t us);
+
+    // The watchdog timing the current frame, nullptr outside frames
+    static FrameWatchdog* current();
+
+    uint32_t getJankCount() const;  // This boot
+    size_t getRecordCount() const;
+    const JankRecord& getRecord(size_t index) const;  // Oldest first
+    void clear();
+    void report(Print& out) const;
+
+   private:
+    uint32_t m_budgetUs;
+    uint32_t m_frameStartUs;
+    uint32_t m_markUs;
+    uint32_t m_jankCount;
+};
@@ -0,0 +1,81 @@
+#ifdef ARDUINO
+#include "MemoryMonitor.hpp"
+
+#include <esp_heap_caps.h>
+
+MemoryMonitor::MemoryMonitor()
+    : m_latest(), m_historyHead(0), m_historyCount(0), m_lastSampleMs(0), m_lastHistoryMs(0), m_taskCount(0) {
+}
+
+void MemoryMonitor::watchTask(const char* name, TaskHandle_t task) {
+    if (task != nullptr && m_taskCount < MEM_MAX_TASKS) {
+        m_tasks[m_taskCount++] = {name, task};
+    }
+}
+
+HeapSample MemoryMonitor::sample(uint32_t nowMs) {
+    return {nowMs, (uint32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT), (uint32_t)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT),
+            (uint32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT)};
+}
+
+void MemoryMonitor::update(uint32_t nowMs) {
+    if (m_latest.timeMs != 0 && nowMs - m_lastSampleMs < MEM_SAMPLE_MS) {
+        return;
+    }
+    m_lastSampleMs = nowMs;
+    m_latest = sample(nowMs);
+
+    if (m_historyCount == 0 || nowMs - m_lastHistoryMs >= MEM_HISTORY_MS) {
+        m_lastHistoryMs = nowMs;
+        m_history[m_historyHead] = m_latest;
+        m_historyHead = (m_historyHead + 1) % MEM_HISTORY;
+        if (m_historyCount < MEM_HISTORY) {
+            m_historyCount++;
+        }
+    }
+}
+
+const HeapSample& MemoryMonitor::getLatest() const {
+    return m_latest;
+}
+
+uint8_t MemoryMonitor::getFragmentation() const {
+    if (m_latest.freeBytes == 0) {
+        return 0;
+    }
+    return 100 - (uint8_t)((uint64_t)m_latest.largestBlock * 100 / m_latest.freeBytes);
+}
+
+int32_t MemoryMonitor::getTrend(uint32_t* spanMs) const {
+    if (m_historyCount == 0) {
+        *spanMs = 0;
+        return 0;
+    }
+    const HeapSample& oldest = m_history[(m_historyHead + MEM_HISTORY - m_historyCount) % MEM_HISTORY];
+    *spanMs = m_latest.timeMs - oldest.timeMs;
+    return (int32_t)m_latest.freeBytes - (int32_t)oldest.freeBytes;
+}
+
+void MemoryMonitor::report(Print& out) const {
+    HeapSample now = sample(millis());
+    uint32_t spanMs;
+    int32_t trend = getTrend(&spanMs);
+
+    out.printf("[mem] heap free %u, largest block %u (%u%% fragmented), min ever %u\n", now.freeBytes, now.largestBlock,
+               now.freeBytes > 0 ? 100 - (unsigned)((uint64_t)now.largestBlock * 100 / now.freeBytes) : 0, now.minFreeBytes);
+    out.printf("[mem] free heap %+d bytes over the last %u min\n", trend, spanMs / 60000);
+
+    out.printf("[mem] %-11s %8s %7s %8s %8s\n", "tag", "bytes", "blocks", "allocs", "peak");
+    for (uint8_t i = 0; i < static_cast<uint8_t>(MemTag::Count); i++) {
+        MemTagStats stats = memStats(static_cast<MemTag>(i));
+        out.printf("[mem] %-11s %8d %7d %8u %8d\n", memTagName(static_cast<MemTag>(i)), stats.bytes, stats.blocks, stats.allocations,
+                   stats.peakBytes);
+    }
+
+    // ESP-IDF reports stack high water marks in bytes
+    for (uint8_t i = 0; i < m_taskCount; i++) {
+        out.printf("[mem] stack %-10s %5u bytes never used\n", m_tasks[i].name, (unsigned)uxTaskGetStackHighWaterMark(m_tasks[i].handle));
+    }
+}
+
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+#ifdef ARDUINO
+#include "Arduino.h"
+#include "MemoryTags.hpp"
+
+#define MEM_SAMPLE_MS 1000
+#define MEM_HISTORY_MS 1800000UL  // One history entry per 30 minutes
+#define MEM_HISTORY 48            // 24 hours of trend
+#define MEM_MAX_TASKS 8
+
+struct HeapSample {
+    uint32_t timeMs;
+    uint32_t freeBytes;
+    uint32_t largestBlock;
+    uint32_t minFreeBytes;  // Lowest free heap since boot
+};
+
+// Periodic heap statistics and task stack headroom, reported together with
+// the per-subsystem counters from MemoryTags. Sampling happens in the UI loop.
+class MemoryMonitor {
+   public:
+    MemoryMonitor();
+
+    void watchTask(const char* name, TaskHandle_t task);
+    void update(uint32_t nowMs);
+
+    const HeapSample& getLatest() const;
+
+    // Share of the free heap that cannot be handed out as one block, in percent
+    uint8_t getFragmentation() const;
+
+    // Free heap change over the recorded history, negative while leaking
+    int32_t getTrend(uint32_t* spanMs) const;
+
+    void report(Print& out) const;
+
+   private:
+    struct WatchedTask {
+        const char* name;
+        TaskHandle_t handle;
+    };
+
+    HeapSample m_latest;
+    HeapSample m_history[MEM_HISTORY];
+    uint8_t m_historyHead;
+    uint8_t m_historyCount;
+    uint32_t m_lastSampleMs;
+    uint32_t m_lastHistoryMs;
+    WatchedTask m_tasks[MEM_MAX_TASKS];
+    uint8_t m_taskCount;
+
+    static HeapSample sample(uint32_t nowMs);
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifdef ARDUINO
+#include "MemoryOverlay.hpp"
+
+MemoryOverlay::MemoryOverlay(Rectangle rect, const MemoryMonitor& monitor)
+    : Component(rect), m_monitor(monitor), m_shownFreeKb(0), m_shownLargestKb(0), m_shownMinKb(0) {
+}
+
+void MemoryOverlay::refresh() {
+    const HeapSample& latest = m_monitor.getLatest();
+    if (latest.freeBytes / 1024 != m_shownFreeKb || latest.largestBlock / 1024 != m_shownLargestKb || latest.minFreeBytes / 1024 != m_shownMinKb) {
+        markDirty();
+    }
+}
+
+void MemoryOverlay::draw(lgfx::LovyanGFX& lcd, const Theme& theme) {
+    if (!needsRedraw) {
+        return;
+    }
+
+    const HeapSample& latest = m_monitor.getLatest();
+    m_shownFreeKb = latest.freeBytes / 1024;
+    m_shownLargestKb = latest.largestBlock / 1024;
+    m_shownMinKb = latest.minFreeBytes / 1024;
+
+    char line[48];
+    snprintf(line, sizeof(line), "heap %uk blk %uk min %uk", m_shownFreeKb, m_shownLargestKb, m_shownMinKb);
+
+    float textSize = lcd.getTextSizeX();
+    lcd.setTextSize(1);
+    lcd.fillRect(bounds.origin.x, bounds.origin.y, bounds.w, bounds.h, theme.screen);
+    lcd.setTextColor(theme.get(STYLE_NORMAL).background, theme.screen);
+    lcd.setCursor(bounds.origin.x + 2, bounds.origin.y + (bounds.h - lcd.fontHeight()) / 2);
+    lcd.print(line);
+    lcd.setTextSize(textSize);
+
+    markClean();
+}
+
+bool MemoryOverlay::isOpaque() const {
+    return true;
+}
+
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+#ifdef ARDUINO
+#include "../GUI/component.hpp"
+#include "MemoryMonitor.hpp"
+
+// One line of heap figures in a corner of the screen (build with -D UNIMIX_MEM_OVERLAY)
+class MemoryOverlay : public Component {
+   public:
+    MemoryOverlay(Rectangle rect, const MemoryMonitor& monitor);
+
+    // Called once per frame, redraws only when the shown figures change
+    void refresh();
+
+    void draw(lgfx::LovyanGFX& lcd, const Theme& theme) override;
+    bool isOpaque() const override;
+
+   private:
+    const MemoryMonitor& m_monitor;
+    uint32_t m_shownFreeKb;
+    uint32_t m_shownLargestKb;
+    uint32_t m_shownMinKb;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include "MemoryTags.hpp"
+
+#include <atomic>
+
+struct TagCounters {
+    std::atomic<int32_t> bytes;
+    std::atomic<int32_t> blocks;
+    std::atomic<uint32_t> allocations;
+    std::atomic<int32_t> peakBytes;
+};
+
+static TagCounters s_tags[static_cast<size_t>(MemTag::Count)];
+
+static const char* const TAG_NAMES[] = {"components", "strings", "sprites", "protocol", "assets"};
+
+static void addBytes(TagCounters& tag, int32_t delta) {
+    int32_t now = tag.bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    int32_t peak = tag.peakBytes.load(std::memory_order_relaxed);
+    while (now > peak && !tag.peakBytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+void memAlloc(MemTag tag, size_t bytes) {
+    TagCounters& counters = s_tags[static_cast<size_t>(tag)];
+    counters.blocks.fetch_add(1, std::memory_order_relaxed);
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    addBytes(counters, (int32_t)bytes);
+}
+
+void memFree(MemTag tag, size_t bytes) {
+    TagCounters& counters = s_tags[static_cast<size_t>(tag)];
+    counters.blocks.fetch_sub(1, std::memory_order_relaxed);
+    addBytes(counters, -(int32_t)bytes);
+}
+
+void memResize(MemTag tag, size_t oldBytes, size_t newBytes) {
+    addBytes(s_tags[static_cast<size_t>(tag)], (int32_t)newBytes - (int32_t)oldBytes);
+}
+
+MemTagStats memStats(MemTag tag) {
+    const TagCounters& counters = s_tags[static_cast<size_t>(tag)];
+    return {counters.bytes.load(std::memory_order_relaxed), counters.blocks.load(std::memory_order_relaxed),
+            counters.allocations.load(std::memory_order_relaxed), counters.peakBytes.load(std::memory_order_relaxed)};
+}
+
+const char* memTagName(MemTag tag) {
+    return tag < MemTag::Count ? TAG_NAMES[static_cast<size_t>(tag)] : "?";
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-subsystem memory accounting. Owners report their allocations as they
+// make them, so a slow leak shows up under the subsystem that causes it.
+// Counters are atomic, any task may report.
+enum class MemTag : uint8_t {
+    Components,  // Component objects and the child lists holding them
+    Strings,     // Labels
+    Sprites,     // Off-screen buffers
+    Protocol,    // Message queues and link buffers
+    Assets,      // SD card cache and loads in flight
+    Count
+};
+
+struct MemTagStats {
+    int32_t bytes;         // Currently held
+    int32_t blocks;        // Currently held
+    uint32_t allocations;  // Since boot
+    int32_t peakBytes;
+};
+
+void memAlloc(MemTag tag, size_t bytes);
+void memFree(MemTag tag, size_t bytes);
+
+// Size change of an existing block (a vector growing), not counted as an allocation
+void memResize(MemTag tag, size_t oldBytes, size_t newBytes);
+
+MemTagStats memStats(MemTag tag);
+const char* memTagName(MemTag tag);
+
+// Accounts a container's capacity change around an insertion
+template <typename Vector>
+inline void memTrackGrowth(MemTag tag, const Vector& vector, size_t capacityBefore) {
+    if (vector.capacity() != capacityBefore) {
+        memResize(tag, capacityBefore * sizeof(typename Vector::value_type), vector.capacity() * sizeof(typename Vector::value_type));
+    }
+}
@@ -0,0 +1,157 @@
+#include "Log.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+
+// Bounded multi-producer ring: each slot carries a sequence number telling
+// producers and the drain whose turn it is, so neither side takes a lock.
+// Slot i starts at sequence i; it is stored minus i so zeroed statics are ready.
+struct LogSlot {
+    std::atomic<uint32_t> sequence;
+    LogRecord record;
+};
+
+static LogSlot s_slots[LOG_RING_RECORDS];
+static std::atomic<uint32_t> s_head(0);
+static uint32_t s_tail = 0;  // Drain side only
+static std::atomic<uint32_t> s_dropped(0);
+static uint32_t s_reportedDropped = 0;
+
+static uint32_t loadSequence(uint32_t index) {
+    return s_slots[index].sequence.load(std::memory_order_acquire) + index;
+}
+
+static void storeSequence(uint32_t index, uint32_t sequence) {
+    s_slots[index].sequence.store(sequence - index, std::memory_order_release);
+}
+
+void logCommit(const LogRecord& record) {
+    uint32_t position = s_head.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32_t index = position & (LOG_RING_RECORDS - 1);
+        int32_t lag = (int32_t)(loadSequence(index) - position);
+        if (lag == 0) {
+            if (s_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                s_slots[index].record = record;
+                storeSequence(index, position + 1);
+                return;
+            }
+        } else if (lag < 0) {
+            s_dropped.fetch_add(1, std::memory_order_relaxed);  // Full, never wait
+            return;
+        } else {
+            position = s_head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+uint32_t logDroppedCount() {
+    return s_dropped.load(std::memory_order_relaxed);
+}
+
+static const char LEVEL_LETTERS[] = "-EWIDV";
+
+// printf for one stored record: each conversion takes the next stored argument
+static void logFormat(Print& out, const LogRecord& record) {
+    char line[160];
+    size_t length = snprintf(line, sizeof(line), "[%7lu %c] ", (unsigned long)record.timeMs, LEVEL_LETTERS[record.level < 6 ? record.level : 0]);
+    uint8_t nextArg = 0;
+    bool textUsed = false;
+
+    for (const char* p = record.format; *p != '\0' && length < sizeof(line) - 1;) {
+        if (*p != '%') {
+            line[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            line[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Copy flags, width and precision, drop length modifiers since arguments are 32 bits
+        char spec[16];
+        size_t specLength = 0;
+        spec[specLength++] = *p++;
+        while (*p != '\0' && strchr("-+ #0123456789.", *p) != nullptr && specLength < sizeof(spec) - 3) {
+            spec[specLength++] = *p++;
+        }
+        while (*p != '\0' && strchr("hlzjt", *p) != nullptr) {
+            p++;
+        }
+        char conversion = *p != '\0' ? *p++ : 'd';
+        spec[specLength++] = conversion;
+        spec[specLength] = '\0';
+
+        char* target = line + length;
+        size_t room = sizeof(line) - length;
+        int written;
+        if (conversion == 's') {
+            written = snprintf(target, room, spec, record.hasText && !textUsed ? record.text : "?");
+            textUsed = true;
+        } else {
+            uint32_t value = nextArg < record.argCount ? record.args[nextArg++] : 0;
+            if (conversion == 'd' || conversion == 'i') {
+                written = snprintf(target, room, spec, (int)(int32_t)value);
+            } else if (conversion == 'c') {
+                written = snprintf(target, room, spec, (int)value);
+            } else {
+                written = snprintf(target, room, spec, (unsigned int)value);
+            }
+        }
+        if (written > 0) {
+            length += std::min<size_t>(written, room - 1);
+        }
+    }
+
+    line[length] = '\0';
+    out.println(line);
+}
+
+size_t logDrain(Print& out) {
+    size_t count = 0;
+    for (;;) {
+        uint32_t index = s_tail & (LOG_RING_RECORDS - 1);
+        if ((int32_t)(loadSequence(index) - (s_tail + 1)) < 0) {
+            break;  // Empty, or the producer has not finished writing this slot
+        }
+        LogRecord record = s_slots[index].record;
+        storeSequence(index, s_tail + LOG_RING_RECORDS);
+        s_tail++;
+        logFormat(out, record);
+        count++;
+    }
+
+    uint32_t dropped = logDroppedCount();
+    if (dropped != s_reportedDropped) {
+        out.printf("[log] %lu records dropped\n", (unsigned long)(dropped - s_reportedDropped));
+        s_reportedDropped = dropped;
+    }
+    return count;
+}
+
+#ifdef ARDUINO
+static Print* s_output = nullptr;
+static TaskHandle_t s_task = nullptr;
+
+static void logTaskEntry(void* arg) {
+    for (;;) {
+        logDrain(*s_output);
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_MS));
+    }
+}
+
+void logStart(Print& out, BaseType_t core) {
+    if (s_output != nullptr) {
+        return;
+    }
+    s_output = &out;
+    xTaskCreatePinnedToCore(logTaskEntry, "log", LOG_TASK_STACK, nullptr, LOG_TASK_PRIORITY, &s_task, core);
+}
+
+TaskHandle_t logTask() {
+    return s_task;
+}
+#endif
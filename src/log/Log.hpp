@@ -0,0 +1,127 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "Arduino.h"
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_VERBOSE 5
+
+// Levels above this are compiled out entirely, arguments included
+#ifndef UNIMIX_LOG_LEVEL
+#define UNIMIX_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_RING_RECORDS 64  // Power of two
+#define LOG_MAX_ARGS 8
+#define LOG_TEXT_BYTES 24
+#define LOG_TASK_STACK 3072
+#define LOG_TASK_PRIORITY 1
+#define LOG_DRAIN_MS 20
+
+// Logging that never waits on the UART. A call stores the format pointer, a
+// timestamp and its arguments as a binary record in a lock-free ring (any
+// task or ISR may log); a low-priority task formats and prints the records.
+//
+// Formats must be string literals. Arguments are integers, enums or one
+// string, which is copied (truncated to LOG_TEXT_BYTES - 1) since it may be
+// gone by the time the record is printed. Integers are stored as 32 bits.
+struct LogRecord {
+    const char* format;
+    uint32_t timeMs;
+    uint8_t level;
+    uint8_t argCount;
+    uint8_t hasText;
+    uint32_t args[LOG_MAX_ARGS];
+    char text[LOG_TEXT_BYTES];
+};
+
+inline void logStore(LogRecord& record, const char* text) {
+    if (record.hasText) {
+        return;  // Only one string per record, the rest print as "?"
+    }
+    record.hasText = 1;
+    size_t i = 0;
+    for (; text != nullptr && text[i] != '\0' && i < LOG_TEXT_BYTES - 1; i++) {
+        record.text[i] = text[i];
+    }
+    record.text[i] = '\0';
+}
+
+inline void logStore(LogRecord& record, const String& text) {
+    logStore(record, text.c_str());
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type logStore(LogRecord& record, T value) {
+    if (record.argCount < LOG_MAX_ARGS) {
+        record.args[record.argCount++] = static_cast<uint32_t>(value);
+    }
+}
+
+inline void logPack(LogRecord&) {
+}
+
+template <typename T, typename... Rest>
+inline void logPack(LogRecord& record, const T& value, const Rest&... rest) {
+    logStore(record, value);
+    logPack(record, rest...);
+}
+
+// Queue a finished record, dropped (and counted) when the ring is full
+void logCommit(const LogRecord& record);
+
+template <typename... Args>
+inline void logWrite(uint8_t level, const char* format, const Args&... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "logWrite: too many arguments");
+    LogRecord record;
+    record.format = format;
+    record.timeMs = millis();
+    record.level = level;
+    record.argCount = 0;
+    record.hasText = 0;
+    logPack(record, args...);
+    logCommit(record);
+}
+
+// Formats and prints everything queued so far, returns the number of records
+size_t logDrain(Print& out);
+uint32_t logDroppedCount();
+
+#ifdef ARDUINO
+// Drain task printing to out
+void logStart(Print& out, BaseType_t core = 0);
+TaskHandle_t logTask();
+#endif
+
+#if UNIMIX_LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_E(...) logWrite(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_E(...) do {} while (0)
+#endif
+#if UNIMIX_LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_W(...) logWrite(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_W(...) do {} while (0)
+#endif
+#if UNIMIX_LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_I(...) logWrite(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_I(...) do {} while (0)
+#endif
+#if UNIMIX_LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_D(...) logWrite(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_D(...) do {} while (0)
+#endif
+#if UNIMIX_LOG_LEVEL >= LOG_LEVEL_VERBOSE
+#define LOG_V(...) logWrite(LOG_LEVEL_VERBOSE, __VA_ARGS__)
+#else
+#define LOG_V(...) do {} while (0)
+#endif
@@ -0,0 +1,87 @@
+#ifdef UNIMIX_USE_LVGL
+#include "LvglBackend.hpp"
+
+// Internal DRAM is DMA capable, so plain static buffers can go straight to the SPI DMA
+static lv_color_t s_buffer1[LVGL_BUFFER_WIDTH * LVGL_BUFFER_LINES];
+static lv_color_t s_buffer2[LVGL_BUFFER_WIDTH * LVGL_BUFFER_LINES];
+
+LvglBackend::LvglBackend(LGFX& lcd)
+    : m_lcd(lcd), m_lastRefreshMs(0), m_lastRefreshPixels(0), m_flushCount(0) {
+}
+
+void LvglBackend::begin() {
+    lv_init();
+
+    lv_disp_draw_buf_init(&m_drawBuffer, s_buffer1, s_buffer2, LVGL_BUFFER_WIDTH * LVGL_BUFFER_LINES);
+
+    lv_disp_drv_init(&m_displayDriver);
+    m_displayDriver.hor_res = m_lcd.width();
+    m_displayDriver.ver_res = m_lcd.height();
+    m_displayDriver.flush_cb = LvglBackend::flush;
+    m_displayDriver.monitor_cb = LvglBackend::monitor;
+    m_displayDriver.draw_buf = &m_drawBuffer;
+    m_displayDriver.user_data = this;
+    lv_disp_drv_register(&m_displayDriver);
+
+    lv_indev_drv_init(&m_inputDriver);
+    m_inputDriver.type = LV_INDEV_TYPE_POINTER;
+    m_inputDriver.read_cb = LvglBackend::readTouch;
+    m_inputDriver.user_data = this;
+    lv_indev_drv_register(&m_inputDriver);
+}
+
+void LvglBackend::update() {
+    lv_timer_handler();
+}
+
+uint32_t LvglBackend::getLastRefreshMs() const {
+    return m_lastRefreshMs;
+}
+
+uint32_t LvglBackend::getLastRefreshPixels() const {
+    return m_lastRefreshPixels;
+}
+
+uint32_t LvglBackend::getFlushCount() const {
+    return m_flushCount;
+}
+
+void LvglBackend::flush(lv_disp_drv_t* driver, const lv_area_t* area, lv_color_t* pixels) {
+    LvglBackend* self = static_cast<LvglBackend*>(driver->user_data);
+    LGFX& lcd = self->m_lcd;
+
+    // The transaction stays open for the whole refresh, monitor() closes it
+    if (lcd.getStartCount() == 0) {
+        lcd.startWrite();
+    }
+
+    // pushImageDMA waits for the previous transfer itself, so the buffer can be
+    // handed back right away and LVGL renders the next area while this one is sent
+    lcd.pushImageDMA(area->x1, area->y1, lv_area_get_width(area), lv_area_get_height(area), (lgfx::rgb565_t*)&pixels->full);
+    self->m_flushCount++;
+    lv_disp_flush_ready(driver);
+}
+
+void LvglBackend::monitor(lv_disp_drv_t* driver, uint32_t timeMs, uint32_t pixels) {
+    LvglBackend* self = static_cast<LvglBackend*>(driver->user_data);
+    self->m_lcd.waitDMA();
+    self->m_lcd.endWrite();  // Release the bus for touch and SD between refreshes
+    self->m_lastRefreshMs = timeMs;
+    self->m_lastRefreshPixels = pixels;
+}
+
+void LvglBackend::readTouch(lv_indev_drv_t* driver, lv_indev_data_t* data) {
+    LvglBackend* self = static_cast<LvglBackend*>(driver->user_data);
+
+    // The XPT2046 pulls IRQ low while pressed, skip the SPI read when it is idle
+    int x = 0, y = 0;
+    if (digitalRead(TOUCH_IRQ) == LOW && self->m_lcd.getTouch(&x, &y)) {
+        data->state = LV_INDEV_STATE_PR;
+        data->point.x = x;
+        data->point.y = y;
+    } else {
+        data->state = LV_INDEV_STATE_REL;
+    }
+}
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#ifdef UNIMIX_USE_LVGL
+
+#include <lvgl.h>
+#include "ESP32_SPI_9341.h"
+
+// Partial draw buffers, two of them so LVGL renders one while the other is on the DMA
+#define LVGL_BUFFER_WIDTH 320
+#define LVGL_BUFFER_LINES 24
+
+// LVGL display and input drivers on top of the existing LGFX panel and XPT2046
+class LvglBackend {
+   public:
+    LvglBackend(LGFX& lcd);
+
+    // Call after the panel is initialized and calibrated (GuiManager::init)
+    void begin();
+    void update();
+
+    // Stats of the last completed refresh, filled by LVGL's monitor callback
+    uint32_t getLastRefreshMs() const;
+    uint32_t getLastRefreshPixels() const;
+    uint32_t getFlushCount() const;
+
+   private:
+    LGFX& m_lcd;
+    lv_disp_draw_buf_t m_drawBuffer;
+    lv_disp_drv_t m_displayDriver;
+    lv_indev_drv_t m_inputDriver;
+    uint32_t m_lastRefreshMs;
+    uint32_t m_lastRefreshPixels;
+    uint32_t m_flushCount;
+
+    static void flush(lv_disp_drv_t* driver, const lv_area_t* area, lv_color_t* pixels);
+    static void monitor(lv_disp_drv_t* driver, uint32_t timeMs, uint32_t pixels);
+    static void readTouch(lv_indev_drv_t* driver, lv_indev_data_t* data);
+};
+
+#endif
@@ -1,17 +1,56 @@
 // 测试通过
 #include <SPI.h>
+#include <esp_log.h>
 
 #include <vector>
 
 #include "ESP32_SPI_9341.h"
 #include "GUI/GuiManager.hpp"
+#include "app/MixerUi.hpp"
+#include "assets/AssetLoader.hpp"
+#include "assets/FontFile.hpp"
+#include "comm/CommLink.hpp"
+#include "comm/FramePrint.hpp"
+#include "comm/SerialTransport.hpp"
+#include "comm/UdpTransport.hpp"
+#include "diag/DiagConsole.hpp"
+#include "diag/FrameWatchdog.hpp"
+#include "diag/MemoryMonitor.hpp"
+#include "log/Log.hpp"
+#include "media/ArtworkLoader.hpp"
+#include "media/ArtworkView.hpp"
+#include "mirror/ScreenMirror.hpp"
+#include "mixer/MixerModel.hpp"
+#include "mixer/ModelBindings.hpp"
+#include "mixer/StateStore.hpp"
+#include "mixer/StateSync.hpp"
+#include "power/CpuGovernor.hpp"
+#include "power/PowerManager.hpp"
+#include "storage/PartitionFlash.hpp"
+
+#ifdef UNIMIX_USE_LVGL
+#include "lvgl/LvglBackend.hpp"
+#endif
+#ifdef UNIMIX_RENDER_BENCH
+#include "bench/RenderBench.hpp"
+#endif
+#ifdef UNIMIX_MEM_OVERLAY
+#include "diag/MemoryOverlay.hpp"
+#endif
+#ifdef UNIMIX_TRACE_RECORD
+#include <SD.h>
+#include "trace/TraceRecorder.hpp"
+#define TRACE_FILE "/trace.umt"
+#endif
 
 using namespace std;
 
-#define SD_SCK 18
-#define SD_MISO 19
-#define SD_MOSI 23
+// The card shares the panel's bus (touch has the other SPI host), with its own select
+#define SD_SCK 14
+#define SD_MISO 12
+#define SD_MOSI 13
 #define SD_CS 5
+#define SD_FONT_PATH "/fonts/ui_font.umf"
 
 #define DEFAULT_TEXT_SIZE 3
 
@@ -22,6 +61,52 @@ int led_pin[3] = {17, 4, 16};
 LGFX lcd;
 GuiManager guiManager(lcd);
 
+InboxQueue inbox;
+OutboxQueue outbox;
+BulkQueue bulkQueue;
+#ifdef UNIMIX_WIFI_SSID
+UdpTransport transport(UNIMIX_WIFI_SSID, UNIMIX_WIFI_PASSWORD);
+// Serial is free for text when the mixer protocol runs over Wi-Fi
+Print& logOutput = Serial;
+Print& consoleOutput = Serial;
+#else
+SerialTransport transport(Serial);
+// The port carries the mixer protocol, so text goes out as frames from the comm task too
+BulkQueue logQueue;      // Log task -> host
+BulkQueue consoleQueue;  // UI task -> host
+FramePrint logOutput(logQueue, LOG_DRAIN_MS);
+FramePrint consoleOutput(consoleQueue);
+#endif
+CommLink commLink(transport, inbox, outbox);
+MixerModel mixerModel;
+StateSync stateSync(mixerModel);
+PartitionFlash stateFlash("mixstate");
+StateStore stateStore(stateFlash);
+PresetBank presets(mixerModel, stateSync);
+ModelBindings modelBindings;
+PowerManager powerManager(lcd, guiManager, LIGHT_ADC, TOUCH_IRQ);
+CpuGovernor cpuGovernor;
+MemoryMonitor memoryMonitor;
+DiagConsole diagConsole;
+FrameWatchdog frameWatchdog;
+ScreenMirror screenMirror(guiManager, bulkQueue);
+ArtworkLoader artworkLoader;
+ArtworkView* artworkView = nullptr;
+AssetLoader assetLoader;
+FontFile cardFont;
+Theme cardTheme;
+#ifdef UNIMIX_MEM_OVERLAY
+MemoryOverlay* memoryOverlay = nullptr;
+#endif
+
+#ifdef UNIMIX_USE_LVGL
+LvglBackend lvgl(lcd);
+#endif
+#ifdef UNIMIX_TRACE_RECORD
+TraceRecorder traceRecorder;
+void flushTrace();
+#endif
+
 void led_set(int i);
 void setup(void) {
     pinMode(led_pin[0], OUTPUT);
@@ -29,6 +114,16 @@ void setup(void) {
     pinMode(led_pin[2], OUTPUT);
 
     Serial.begin(115200);
+#ifndef UNIMIX_WIFI_SSID
+    esp_log_level_set("*", ESP_LOG_NONE);  // ESP-IDF would print straight onto the protocol
+#endif
+    logStart(logOutput, 0);
+
+    // Stalls from before a soft reset are still in RTC memory
+    frameWatchdog.begin();
+    if (frameWatchdog.getRecordCount() > 0) {
+        LOG_W("%u janky frames kept from earlier boots, type \"jank\" for details", frameWatchdog.getRecordCount());
+    }
 
     // pinMode(LCD_BL, OUTPUT);
     // digitalWrite(LCD_BL, HIGH);
@@ -36,16 +131,247 @@ void setup(void) {
     // Initialize GUI Manager
     guiManager.init();
 
-    // Create and add GUI components using helper method
-    Button* btn = guiManager.createButton(10, 10, 200, 100, "hello");
+    // Host updates arrive on core 0 and are applied to the model from the UI loop
+    guiManager.setMessageQueues(&inbox, &outbox);
+    guiManager.onMessage = [](const MixerMessage& message) {
+        if (artworkLoader.receive(message)) {
+            return;
+        }
+        stateSync.handle(message, millis());
+    };
+    stateSync.send = [](const MixerMessage& message) {
+        return guiManager.postEvent(message);
+    };
+    stateSync.onChange = [](uint8_t session, uint8_t fields) {
+        modelBindings.notify(session, fields);
+        stateStore.markDirty(session, fields, millis());
+    };
+
+    // The sessions from before the reboot show until the host's snapshot replaces them
+    stateStore.load(mixerModel);
+    stateStore.start(0);
+    presets.load();
+#ifndef UNIMIX_WIFI_SSID
+    commLink.addBulkQueue(&consoleQueue);
+    commLink.addBulkQueue(&logQueue);
+#endif
+    commLink.addBulkQueue(&bulkQueue);  // Screen mirror, see below
+    commLink.start(0);
+    stateSync.begin(millis());
+
+    // Typed into the serial monitor; with the serial link they arrive between frames
+    diagConsole.addCommand("mem", "heap, per-subsystem memory and task stacks", [](Print& out) {
+        memoryMonitor.report(out);
+    });
+    diagConsole.addCommand("cpu", "clock scaling statistics", [](Print& out) {
+        cpuGovernor.report(out);
+    });
+    diagConsole.addCommand("draw", "display list replay cost per command type, then reset", [](Print& out) {
+        reportDrawOpStats(out);
+        resetDrawOpStats();
+    });
+    diagConsole.addCommand("store", "saved mixer state and flash wear", [](Print& out) {
+        out.printf("[store] sector %u of %u, generation %u, %u of %u slots used, %u records written, %u compactions, %u errors\n",
+                   stateStore.getSector(), stateStore.getSectorCount(), stateStore.getGeneration(), stateStore.getUsedSlots(),
+                   STORE_SLOTS_PER_SECTOR, stateStore.getRecordsWritten(), stateStore.getCompactions(), stateStore.getErrors());
+    });
+    diagConsole.addCommand("presets", "stored presets", [](Print& out) {
+        for (uint8_t i = 0; i < presets.getCount(); i++) {
+            const Preset& preset = presets.get(i);
+            out.printf("[presets] %s:", preset.name);
+            for (uint8_t entry = 0; entry < preset.count; entry++) {
+                out.printf(" %s %d%s", preset.entries[entry].session, preset.entries[entry].volume, preset.entries[entry].muted ? " muted" : "");
+            }
+            out.println();
+        }
+    });
+    // "save-meeting" etc. store the current mix under that preset
+    static char saveCommands[MAX_PRESETS][PRESET_NAME_LEN + 5];
+    for (uint8_t i = 0; i < presets.getCount(); i++) {
+        snprintf(saveCommands[i], sizeof(saveCommands[i]), "save-%s", presets.get(i).name);
+        diagConsole.addCommand(saveCommands[i], "store the current volumes as this preset", [i](Print& out) {
+            out.println(presets.save(i) ? "[presets] saved" : "[presets] not saved");
+        });
+    }
+    diagConsole.addCommand("jank", "frames over budget and their slowest components", [](Print& out) {
+        frameWatchdog.report(out);
+    });
+    diagConsole.addCommand("jank-clear", "forget recorded janky frames", [](Print& out) {
+        frameWatchdog.clear();
+        out.println("[jank] cleared");
+    });
+#ifndef UNIMIX_WIFI_SSID
+    transport.onStrayByte = [](uint8_t byte) {
+        diagConsole.feed(byte);
+    };
+#endif
+
+#ifdef UNIMIX_USE_LVGL
+    // GuiManager still brings up the panel and touch calibration, LVGL renders from here on
+    lvgl.begin();
+#ifdef UNIMIX_RENDER_BENCH
+    runRenderBench(guiManager, lvgl, lcd, consoleOutput);
+#endif
+    lv_obj_t* btn = lv_btn_create(lv_scr_act());
+    lv_obj_set_pos(btn, 10, 10);
+    lv_obj_set_size(btn, 200, 100);
+    lv_obj_t* label = lv_label_create(btn);
+    lv_label_set_text(label, "hello");
+    lv_obj_center(label);
+#else
+    buildMixerUi(guiManager);
+    Row* presetBar = buildPresetBar(guiManager, presets);
+
+    // Album art decodes on core 0 next to the link, the UI only copies bytes and pixels.
+    // Right-aligned above the preset bar, clear of the bar and the button on the left.
+    if (artworkLoader.start(0)) {
+        int artX = guiManager.getWidth() - ART_SIZE - ART_VIEW_MARGIN;
+        int artY = presetBar->bounds.origin.y - ART_SIZE - ART_VIEW_MARGIN;
+        artworkView = new ArtworkView(Rectangle(artX, artY, ART_SIZE, ART_SIZE), artworkLoader);
+        guiManager.addComponent(artworkView);
+    }
+    diagConsole.addCommand("art", "album art decodes", [](Print& out) {
+        out.printf("[art] %u decoded, %u failed, %u dropped, last decode %u ms\n", artworkLoader.getDecoded(), artworkLoader.getFailed(),
+                   artworkLoader.getDropped(), artworkLoader.getLastDecodeMs());
+    });
+    guiManager.setFrameWatchdog(&frameWatchdog);
+
+    // A font on the card covers more scripts than the compiled-in atlas, it takes over once loaded
+    if (assetLoader.begin(lcd, SD_SCK, SD_MISO, SD_MOSI, SD_CS)) {
+        assetLoader.request(SD_FONT_PATH, [](const char* path, const uint8_t* data, size_t size) {
+            uint8_t* file = data != nullptr ? assetLoader.take(path, &size) : nullptr;
+            if (file != nullptr && cardFont.load(file, size)) {
+                cardTheme = guiManager.getTheme();
+                cardTheme.font = cardFont.get();
+                guiManager.setTheme(cardTheme);
+                LOG_I("Font %s loaded, %u glyphs", path, cardFont.get()->glyphCount);
+            }
+        });
+    }
+    diagConsole.addCommand("assets", "SD card and asset cache", [](Print& out) {
+        out.printf("[assets] card %s, %u bytes cached, %s, font from %s\n", assetLoader.isMounted() ? "mounted" : "missing",
+                   assetLoader.getCachedBytes(), assetLoader.isBusy() ? "loading" : "idle",
+                   cardFont.get() != nullptr ? "card" : "flash");
+    });
+
+    // Remote screenshots and live monitoring, started from the console (tools/mirror_view.py)
+    setDamageHandler(DamageHandler::bind<ScreenMirror, &ScreenMirror::damage>(&screenMirror));
+    diagConsole.addCommand("mirror", "stream the screen to the host", [](Print& out) {
+        if (!screenMirror.start()) {
+            out.println("[mirror] not enough memory");
+        }
+        screenMirror.report(out);
+    });
+    diagConsole.addCommand("mirror-off", "stop streaming the screen", [](Print& out) {
+        screenMirror.stop();
+        screenMirror.report(out);
+    });
+
+#ifdef UNIMIX_TRACE_RECORD
+    // Everything from here on can be replayed with env:native-replay. The card
+    // was mounted by the asset loader, on the panel's bus.
+    if (!assetLoader.isMounted()) {
+        LOG_E("Trace: no SD card, nothing is saved");
+    }
+    guiManager.setTraceRecorder(&traceRecorder);
+    traceRecorder.start(millis());
+    diagConsole.addCommand("trace", "write the recorded input to " TRACE_FILE " now", [](Print& out) {
+        flushTrace();
+        out.printf("[trace] %u bytes in " TRACE_FILE "%s\n", traceRecorder.getFlushedBytes(),
+                   traceRecorder.isRecording() ? ", still recording" : ", stopped");
+    });
+#endif
+
+    // Backlight follows the room, dims and blanks when nobody is using the mixer
+    powerManager.begin(0);
+    cpuGovernor.begin();
+
+#ifdef UNIMIX_MEM_OVERLAY
+    memoryOverlay = new MemoryOverlay(Rectangle(0, guiManager.getHeight() - 12, guiManager.getWidth(), 12), memoryMonitor);
+    guiManager.addComponent(memoryOverlay);
+#endif
+#endif
+
+    memoryMonitor.watchTask("loop", xTaskGetCurrentTaskHandle());
+    memoryMonitor.watchTask("comm_link", commLink.getTask());
+    memoryMonitor.watchTask("log", logTask());
+    memoryMonitor.watchTask("store", stateStore.getTask());
+#ifndef UNIMIX_USE_LVGL
+    memoryMonitor.watchTask("power", powerManager.getTask());
+    memoryMonitor.watchTask("artwork", artworkLoader.getTask());
+#endif
 }
 
 void loop(void) {
+#ifdef UNIMIX_USE_LVGL
+    lvgl.update();
+    delay(5);
+#else
+    // Full clock only while there is UI work. While the panel is blank the link
+    // saves power too, and the CPU light-sleeps if the link keeps receiving
+    // through it (Wi-Fi with modem sleep, never the serial link).
+    transport.setPowerSave(guiManager.isSuspended());
+    cpuGovernor.setLightSleepAllowed(guiManager.isSuspended() && transport.allowsLightSleep());
+    cpuGovernor.setBusy(guiManager.isBusy() || assetLoader.isBusy());
+
     // Update GUI (handle touch events and draw components)
     guiManager.update();
+    // Card reads only happen here, between frames and within a fixed budget
+    assetLoader.pump();
+    stateSync.update(millis());
+    stateStore.update(mixerModel, millis());
+    if (!guiManager.isSuspended()) {
+        screenMirror.update(millis());
+    }
+    if (artworkView != nullptr) {
+        artworkView->refresh();
+    }
+
+    memoryMonitor.update(millis());
+#ifdef UNIMIX_MEM_OVERLAY
+    memoryOverlay->refresh();
+#endif
+#ifdef UNIMIX_WIFI_SSID
+    while (Serial.available() > 0) {
+        diagConsole.feed(Serial.read());
+    }
+#endif
+    diagConsole.poll(consoleOutput);
 
-    delay(20);
+#ifdef UNIMIX_TRACE_RECORD
+    if (traceRecorder.needsFlush(millis())) {
+        flushTrace();
+    }
+#endif
+
+    // Runs faster only while something is animating
+    delay(guiManager.getFrameDelay());
+#endif
+}
+
+#ifdef UNIMIX_TRACE_RECORD
+void flushTrace() {
+    // Between frames, while the panel has released the shared bus; a flush that
+    // cannot claim it stays due for the next loop. Each boot starts the file
+    // over, later flushes append to it.
+    if (traceRecorder.size() == 0 || (assetLoader.isMounted() && !assetLoader.claimBus())) {
+        return;
+    }
+    File file = SD.open(TRACE_FILE, traceRecorder.isFirstFlush() ? FILE_WRITE : FILE_APPEND);
+    bool written = file && file.write(traceRecorder.data(), traceRecorder.size()) == traceRecorder.size();
+    if (file) {
+        file.close();
+    }
+    if (!written) {
+        LOG_E("Trace: cannot write " TRACE_FILE ", recording stopped");
+        traceRecorder.stop();  // A gap would make the rest unreplayable
+    }
+    if (traceRecorder.isFull()) {
+        LOG_W("Trace: buffer filled between flushes, recording stopped");
+    }
+    traceRecorder.flushed(millis());
 }
+#endif
 
 void led_set(int i) {
     if (i == 0) {
@@ -0,0 +1,292 @@
+#ifdef ARDUINO
+#include "ArtworkLoader.hpp"
+
+#include <string.h>
+
+#include <esp32/rom/tjpgd.h>
+
+#include "../diag/MemoryTags.hpp"
+#include "../log/Log.hpp"
+
+// 3 bits red, 3 green, 2 blue: a fixed palette needs no pass over the whole
+// image before the first block can be stored, and nothing to search per pixel
+static uint8_t rgb332Index(uint8_t r, uint8_t g, uint8_t b) {
+    return (r & 0xE0) | ((g >> 5) << 2) | (b >> 6);
+}
+
+static const uint16_t* rgb332Palette() {
+    static uint16_t palette[256];
+    if (palette[255] == 0) {
+        for (int i = 0; i < 256; i++) {
+            uint16_t r = (i >> 5) * 31 / 7, g = ((i >> 2) & 0x07) * 63 / 7, b = (i & 0x03) * 31 / 3;
+            palette[i] = (r << 11) | (g << 5) | b;
+        }
+    }
+    return palette;
+}
+
+// What the decoder callbacks reach through JDEC::device
+struct JpegJob {
+    const uint8_t* data;
+    uint32_t length;
+    uint32_t position;
+    lgfx::LovyanGFX* canvas;
+    int scaledWidth, scaledHeight;  // As the ROM decoder outputs the image
+    int left, top;                  // Placement in the cache, centered
+    int drawnWidth, drawnHeight;
+};
+
+static UINT readJpeg(JDEC* decoder, BYTE* buffer, UINT length) {
+    JpegJob* job = static_cast<JpegJob*>(decoder->device);
+    UINT count = std::min<uint32_t>(length, job->length - job->position);
+    if (buffer != nullptr) {
+        memcpy(buffer, job->data + job->position, count);
+    }
+    job->position += count;  // A null buffer skips
+    return count;
+}
+
+// One decoded block: every source pixel covers the cache pixels its span maps to
+static UINT writeJpeg(JDEC* decoder, void* bitmap, JRECT* rect) {
+    JpegJob* job = static_cast<JpegJob*>(decoder->device);
+    const uint8_t* rgb = static_cast<const uint8_t*>(bitmap);
+    for (int sy = rect->top; sy <= rect->bottom; sy++) {
+        int y0 = job->top + sy * job->drawnHeight / job->scaledHeight;
+        int y1 = job->top + (sy + 1) * job->drawnHeight / job->scaledHeight;
+        for (int sx = rect->left; sx <= rect->right; sx++, rgb += 3) {
+            int x0 = job->left + sx * job->drawnWidth / job->scaledWidth;
+            int x1 = job->left + (sx + 1) * job->drawnWidth / job->scaledWidth;
+            if (y1 > y0 && x1 > x0 && sx < job->scaledWidth && sy < job->scaledHeight) {
+                job->canvas->fillRect(x0, y0, x1 - x0, y1 - y0, (uint16_t)rgb332Index(rgb[0], rgb[1], rgb[2]));
+            }
+        }
+    }
+    if (rect->right + 1 >= job->scaledWidth) {
+        vTaskDelay(1);  // Block rows are the yield points for anything else on this core
+    }
+    return 1;
+}
+
+ArtworkLoader::ArtworkLoader()
+    : m_work(nullptr),
+      m_started(false),
+      m_receiving(nullptr),
+      m_received(0),
+      m_job(nullptr),
+      m_published(-1),
+      m_displayed(-1),
+      m_generation(0),
+      m_decoded(0),
+      m_failed(0),
+      m_dropped(0),
+      m_lastDecodeMs(0) {
+}
+
+ArtworkLoader::~ArtworkLoader() {
+    if (m_task != nullptr) {
+        vTaskDelete(m_task);
+    }
+    dropReceiving();
+    release(m_job.exchange(nullptr));
+    if (m_work != nullptr) {
+        memFree(MemTag::Assets, ART_JPEG_WORK_BYTES);
+        free(m_work);
+    }
+}
+
+bool ArtworkLoader::start(BaseType_t core) {
+    if (m_started) {
+        return true;
+    }
+    for (auto& cache : m_cache) {
+        if (!cache.create(ART_SIZE, ART_SIZE, PaletteDepth::Bits8)) {
+            LOG_E("Artwork: no memory for the %ux%u cache", ART_SIZE, ART_SIZE);
+            m_cache[0].release();
+            return false;
+        }
+        cache.setPalette(rgb332Palette(), 256);
+    }
+    m_work = malloc(ART_JPEG_WORK_BYTES);
+    if (m_work == nullptr) {
+        LOG_E("Artwork: no memory for the decoder");
+        m_cache[0].release();
+        m_cache[1].release();
+        return false;
+    }
+    memAlloc(MemTag::Assets, ART_JPEG_WORK_BYTES);
+    m_started = true;
+
+    xTaskCreatePinnedToCore(ArtworkLoader::taskEntry, "artwork", ART_TASK_STACK, this, ART_TASK_PRIORITY, &m_task, core);
+    return true;
+}
+
+TaskHandle_t ArtworkLoader::getTask() const {
+    return m_task;
+}
+
+ArtworkLoader::EncodedArt* ArtworkLoader::allocate(ArtFormat format, uint32_t length) {
+    EncodedArt* art = static_cast<EncodedArt*>(malloc(sizeof(EncodedArt) + length));
+    if (art != nullptr) {
+        memAlloc(MemTag::Assets, sizeof(EncodedArt) + length);
+        art->format = format;
+        art->length = length;
+    }
+    return art;
+}
+
+void ArtworkLoader::release(EncodedArt* art) {
+    if (art != nullptr) {
+        memFree(MemTag::Assets, sizeof(EncodedArt) + art->length);
+        free(art);
+    }
+}
+
+void ArtworkLoader::dropReceiving() {
+    release(m_receiving);
+    m_receiving = nullptr;
+    m_received = 0;
+}
+
+bool ArtworkLoader::receive(const MixerMessage& message) {
+    switch (message.type) {
+        case MessageType::ArtBegin:
+            dropReceiving();
+            if (!m_started || message.sequence == 0 || message.sequence > ART_MAX_BYTES || message.value != (int16_t)ArtFormat::Jpeg) {
+                LOG_W("Artwork: refused %u byte image", message.sequence);
+                m_dropped++;
+                return true;
+            }
+            m_receiving = allocate((ArtFormat)message.value, message.sequence);
+            if (m_receiving == nullptr) {
+                LOG_W("Artwork: no memory for %u byte image", message.sequence);
+                m_dropped++;
+            }
+            return true;
+
+        case MessageType::ArtChunk:
+            if (m_receiving == nullptr) {
+                return true;  // Rest of a refused or broken transfer
+            }
+            // Chunks arrive in order; a lost one leaves a hole the decoder cannot skip
+            if (message.sequence != m_received || message.value <= 0 || message.value > MESSAGE_TEXT_LEN ||
+                m_received + message.value > m_receiving->length) {
+                LOG_W("Artwork: chunk at %u, expected %u", message.sequence, m_received);
+                dropReceiving();
+                m_dropped++;
+                return true;
+            }
+            memcpy(m_receiving->data + m_received, message.text, message.value);
+            m_received += message.value;
+            return true;
+
+        case MessageType::ArtEnd:
+            if (m_receiving == nullptr) {
+                return true;
+            }
+            if (message.sequence != m_receiving->length || m_received != m_receiving->length) {
+                LOG_W("Artwork: image ended at %u of %u bytes", m_received, m_receiving->length);
+                dropReceiving();
+                m_dropped++;
+                return true;
+            }
+            // An image still waiting for the decoder is out of date now
+            if (EncodedArt* stale = m_job.exchange(m_receiving)) {
+                release(stale);
+                m_dropped++;
+            }
+            m_receiving = nullptr;
+            m_received = 0;
+            xTaskNotifyGive(m_task);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+PaletteBuffer* ArtworkLoader::current() {
+    int8_t published = m_published.load();
+    m_displayed.store(published);
+    return published >= 0 ? &m_cache[published] : nullptr;
+}
+
+uint32_t ArtworkLoader::getGeneration() const {
+    return m_generation.load();
+}
+
+uint32_t ArtworkLoader::getDecoded() const {
+    return m_decoded.load();
+}
+
+uint32_t ArtworkLoader::getFailed() const {
+    return m_failed.load();
+}
+
+uint32_t ArtworkLoader::getDropped() const {
+    return m_dropped.load();
+}
+
+uint32_t ArtworkLoader::getLastDecodeMs() const {
+    return m_lastDecodeMs.load();
+}
+
+void ArtworkLoader::taskEntry(void* arg) {
+    static_cast<ArtworkLoader*>(arg)->run();
+}
+
+void ArtworkLoader::run() {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        EncodedArt* art;
+        while ((art = m_job.exchange(nullptr)) != nullptr) {
+            // The other cache may still be on screen until the UI has picked up the last image
+            while (m_displayed.load() != m_published.load()) {
+                vTaskDelay(pdMS_TO_TICKS(ART_WAIT_MS));
+            }
+            int8_t target = m_published.load() == 0 ? 1 : 0;
+
+            uint32_t startMs = millis();
+            if (decode(*art, m_cache[target])) {
+                m_lastDecodeMs = millis() - startMs;
+                m_decoded++;
+                m_published.store(target);
+                m_generation++;
+                LOG_I("Artwork: %u byte image decoded in %u ms", art->length, m_lastDecodeMs.load());
+            } else {
+                m_failed++;
+                LOG_W("Artwork: cannot decode %u byte image", art->length);
+            }
+            release(art);
+        }
+    }
+}
+
+bool ArtworkLoader::decode(const EncodedArt& art, PaletteBuffer& cache) {
+    JpegJob job = {art.data, art.length, 0, &cache.getCanvas(), 0, 0, 0, 0, 0, 0};
+    JDEC decoder;
+    if (jd_prepare(&decoder, readJpeg, m_work, ART_JPEG_WORK_BYTES, &job) != JDR_OK) {
+        return false;
+    }
+
+    // The strongest ROM reduction that still leaves the longer side at least
+    // ART_SIZE, smaller images are enlarged instead
+    uint8_t reduction = 3;
+    while (reduction > 0 && (std::max(decoder.width, decoder.height) >> reduction) < ART_SIZE) {
+        reduction--;
+    }
+    job.scaledWidth = (decoder.width + (1 << reduction) - 1) >> reduction;
+    job.scaledHeight = (decoder.height + (1 << reduction) - 1) >> reduction;
+
+    // Fit the longer side, center the shorter one on black
+    int longer = std::max(job.scaledWidth, job.scaledHeight);
+    job.drawnWidth = std::max(1, job.scaledWidth * ART_SIZE / longer);
+    job.drawnHeight = std::max(1, job.scaledHeight * ART_SIZE / longer);
+    job.left = (ART_SIZE - job.drawnWidth) / 2;
+    job.top = (ART_SIZE - job.drawnHeight) / 2;
+
+    job.canvas->fillScreen((uint16_t)rgb332Index(0, 0, 0));
+    return jd_decomp(&decoder, writeJpeg, reduction) == JDR_OK;
+}
+
+#endif
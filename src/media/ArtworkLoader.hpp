@@ -0,0 +1,91 @@
+#pragma once
+#ifdef ARDUINO
+#include <atomic>
+
+#include "Arduino.h"
+#include "../GUI/PaletteBuffer.hpp"
+#include "../comm/messages.hpp"
+
+#define ART_SIZE 96                  // Decoded artwork is scaled to fit ART_SIZE x ART_SIZE
+#define ART_MAX_BYTES (48 * 1024)    // Larger images are refused while they arrive
+#define ART_JPEG_WORK_BYTES 3100     // TJpgDec tables and one MCU, the only decoder RAM
+#define ART_TASK_STACK 6144          // The JPEG decoder runs on this stack
+#define ART_TASK_PRIORITY 1
+#define ART_WAIT_MS 20
+
+enum class ArtFormat : uint8_t { Jpeg, Png };
+
+// Album art for the "now playing" view. The host sends the encoded image as
+// ArtBegin / ArtChunk / ArtEnd messages; the UI task only copies the bytes.
+// A low-priority task then decodes it once with the TJpgDec in the ESP32 ROM,
+// which hands over one block of RGB888 pixels at a time. Each block is scaled
+// and reduced straight into an 8 bpp RGB332 palette cache, so the decoder needs
+// only its fixed work area and no full-color buffer. The ROM decoder reduces by
+// 1/2, 1/4 or 1/8 first, the rest of the fit to ART_SIZE is nearest-neighbour.
+// Two caches alternate: the UI draws from the last complete image while the
+// next one decodes into the other, so GuiManager::update() never waits.
+//
+// Only baseline JPEG is accepted. PNG would need a 32 KB inflate window on a
+// heap without PSRAM, so the host converts artwork to JPEG before sending it.
+class ArtworkLoader {
+   public:
+    ArtworkLoader();
+    ~ArtworkLoader();
+
+    // Allocates the caches and the strip, then starts the decode task
+    bool start(BaseType_t core = 0);
+    TaskHandle_t getTask() const;
+
+    // UI task: true when the message was artwork and has been taken
+    bool receive(const MixerMessage& message);
+
+    // UI task: newest complete image, nullptr before the first. The returned
+    // cache stays untouched by the decoder until a later call returns another.
+    PaletteBuffer* current();
+
+    // Bumped by the decoder each time an image completes
+    uint32_t getGeneration() const;
+
+    uint32_t getDecoded() const;
+    uint32_t getFailed() const;
+    uint32_t getDropped() const;  // Transfers refused, broken off or superseded before decoding
+    uint32_t getLastDecodeMs() const;
+
+   private:
+    // One received image, header and bytes in a single allocation
+    struct EncodedArt {
+        ArtFormat format;
+        uint32_t length;
+        uint8_t data[];
+    };
+
+    PaletteBuffer m_cache[2];
+    void* m_work;  // ART_JPEG_WORK_BYTES for the decoder
+    bool m_started;
+    TaskHandle_t m_task = nullptr;
+
+    // UI task, transfer in progress
+    EncodedArt* m_receiving;
+    uint32_t m_received;
+
+    // Handed from the UI task to the decoder, newest only
+    std::atomic<EncodedArt*> m_job;
+
+    std::atomic<int8_t> m_published;  // Cache with the newest image, -1 none
+    std::atomic<int8_t> m_displayed;  // Cache the UI last asked for
+    std::atomic<uint32_t> m_generation;
+    std::atomic<uint32_t> m_decoded;
+    std::atomic<uint32_t> m_failed;
+    std::atomic<uint32_t> m_dropped;
+    std::atomic<uint32_t> m_lastDecodeMs;
+
+    static void taskEntry(void* arg);
+    void run();
+    bool decode(const EncodedArt& art, PaletteBuffer& cache);
+
+    static EncodedArt* allocate(ArtFormat format, uint32_t length);
+    static void release(EncodedArt* art);
+    void dropReceiving();
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifdef ARDUINO
+#include "ArtworkView.hpp"
+
+ArtworkView::ArtworkView(Rectangle rect, ArtworkLoader& loader) : Component(rect), m_loader(loader), m_shownGeneration(0) {
+}
+
+void ArtworkView::refresh() {
+    if (m_loader.getGeneration() != m_shownGeneration) {
+        invalidateList();
+    }
+}
+
+void ArtworkView::draw(lgfx::LovyanGFX& lcd, const Theme& theme) {
+    if (!needsRedraw) {
+        return;
+    }
+
+    replayList(lcd, theme);
+
+    markClean();
+}
+
+bool ArtworkView::isOpaque() const {
+    return true;
+}
+
+Component* ArtworkView::touch(bool, Point) {
+    return nullptr;
+}
+
+void ArtworkView::record(DisplayList& list, lgfx::LovyanGFX& lcd, const Theme& theme) {
+    // Taking the image here releases the previous cache to the decoder; the
+    // list keeps pointing at this one, which the decoder leaves alone until
+    // the next record takes a newer image
+    m_shownGeneration = m_loader.getGeneration();
+    PaletteBuffer* art = m_loader.current();
+
+    list.fillRect(0, 0, bounds.w, bounds.h, ColorRole::Background);
+    if (art == nullptr) {
+        list.frame(0, 0, bounds.w, bounds.h);
+        return;
+    }
+
+    // Already scaled by the decoder, centered and cut to the bounds
+    int width = std::min<int>(bounds.w, ART_SIZE);
+    int height = std::min<int>(bounds.h, ART_SIZE);
+    list.image((bounds.w - width) / 2, (bounds.h - height) / 2, width, height, art, ColorRole::Background, ColorRole::Foreground);
+}
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+#ifdef ARDUINO
+#include "../GUI/component.hpp"
+#include "ArtworkLoader.hpp"
+
+#define ART_VIEW_MARGIN 4  // Gap to the screen edge and to the components around it
+
+// "Now playing" album art, drawn from the loader's palette cache. Until the
+// first image has decoded it shows an empty frame.
+class ArtworkView : public Component {
+   public:
+    ArtworkView(Rectangle rect, ArtworkLoader& loader);
+
+    // Called once per frame, records again only when a newer image has decoded
+    void refresh();
+
+    void draw(lgfx::LovyanGFX& lcd, const Theme& theme) override;
+    bool isOpaque() const override;
+
+    // Display only, touches fall through to whatever lies under it
+    Component* touch(bool touching, Point pos) override;
+
+   protected:
+    void record(DisplayList& list, lgfx::LovyanGFX& lcd, const Theme& theme) override;
+
+   private:
+    ArtworkLoader& m_loader;
+    uint32_t m_shownGeneration;
+};
+
+#endif
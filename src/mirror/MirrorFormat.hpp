@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+
+// Screen mirror stream, carried as BulkFrames (comm/messages.hpp) and decoded by
+// tools/mirror_view.py. Every frame starts with MIRROR_FRAME_TAG and an op:
+//
+//   Hello    width u16, height u16, tile size u8     on start, the viewer resets
+//   Palette  first u8, count u8, count x RGB565 u16  entries the tiles refer to
+//   Tile     column u8, row u8, first pixel u8, runs  part of one tile
+//   Flush                                            every change so far is sent
+//
+// Tiles are MIRROR_TILE pixels square, clipped at the right and bottom edges,
+// pixels in row order. A run byte is (length - 1) << 4 | palette index, so a
+// tile is sent in as many frames as its runs need. Multi-byte values are little
+// endian. Only tiles whose content changed since they were last sent are sent.
+
+#define MIRROR_FRAME_TAG 0xF0
+#define MIRROR_TILE 16
+
+enum class MirrorOp : uint8_t {
+    Hello = 1,
+    Palette,
+    Tile,
+    Flush,
+};
+
+#define MIRROR_TILE_HEADER 5  // Tag, op, column, row, first pixel
@@ -0,0 +1,267 @@
+#include "ScreenMirror.hpp"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "../diag/MemoryTags.hpp"
+
+#define MIRROR_RUNS_PER_FRAME (BULK_FRAME_BYTES - MIRROR_TILE_HEADER)
+
+ScreenMirror::ScreenMirror(GuiManager& gui, BulkQueue& queue)
+    : m_gui(gui),
+      m_queue(queue),
+      m_running(false),
+      m_rendering(false),
+      m_columns(0),
+      m_rows(0),
+      m_nextRow(0),
+      m_nextMs(0),
+      m_helloPending(false),
+      m_flushPending(false),
+      m_sentPaletteCount(0),
+      m_tilesSent(0),
+      m_tilesUnchanged(0),
+      m_bytesQueued(0) {
+    memset(m_sentPalette, 0, sizeof(m_sentPalette));
+}
+
+ScreenMirror::~ScreenMirror() {
+    stop();
+}
+
+bool ScreenMirror::start() {
+    if (!m_running) {
+        int width = m_gui.getWidth();
+        int height = m_gui.getHeight();
+        if (!m_strip.create(width, MIRROR_TILE, PaletteDepth::Bits4)) {
+            return false;
+        }
+        m_columns = (width + MIRROR_TILE - 1) / MIRROR_TILE;
+        m_rows = (height + MIRROR_TILE - 1) / MIRROR_TILE;
+        m_tileHashes.resize(m_columns * m_rows);
+        m_dirty.resize(m_columns * m_rows);
+        memAlloc(MemTag::Protocol, m_tileHashes.capacity() * sizeof(uint32_t) + m_dirty.capacity());
+    }
+
+    // A viewer that asks again has lost what it had, so it gets the hello and every tile anew
+    std::fill(m_tileHashes.begin(), m_tileHashes.end(), 0);
+    std::fill(m_dirty.begin(), m_dirty.end(), 1);
+    m_sentPaletteCount = 0;
+    m_nextRow = 0;
+    m_nextMs = 0;
+    m_helloPending = true;
+    m_flushPending = false;
+    m_running = true;
+    return true;
+}
+
+void ScreenMirror::stop() {
+    if (!m_running) {
+        return;
+    }
+    memFree(MemTag::Protocol, m_tileHashes.capacity() * sizeof(uint32_t) + m_dirty.capacity());
+    std::vector<uint32_t>().swap(m_tileHashes);
+    std::vector<uint8_t>().swap(m_dirty);
+    m_strip.release();
+    m_running = false;
+}
+
+bool ScreenMirror::isRunning() const {
+    return m_running;
+}
+
+void ScreenMirror::damage(const Rectangle& area) {
+    if (!m_running || m_rendering) {
+        return;
+    }
+
+    int column0 = std::max(0, area.origin.x / MIRROR_TILE);
+    int row0 = std::max(0, area.origin.y / MIRROR_TILE);
+    int column1 = std::min(m_columns - 1, (area.origin.x + area.w - 1) / MIRROR_TILE);
+    int row1 = std::min(m_rows - 1, (area.origin.y + area.h - 1) / MIRROR_TILE);
+    for (int row = row0; row <= row1; row++) {
+        for (int column = column0; column <= column1; column++) {
+            m_dirty[row * m_columns + column] = 1;
+        }
+    }
+}
+
+void ScreenMirror::update(uint32_t nowMs) {
+    if (!m_running || (int32_t)(nowMs - m_nextMs) < 0) {
+        return;
+    }
+    m_nextMs = nowMs + MIRROR_INTERVAL_MS;
+    uint32_t startUs = micros();
+
+    if (m_helloPending) {
+        int width = m_gui.getWidth();
+        int height = m_gui.getHeight();
+        uint8_t hello[] = {MIRROR_FRAME_TAG,     (uint8_t)MirrorOp::Hello, (uint8_t)width, (uint8_t)(width >> 8), (uint8_t)height,
+                           (uint8_t)(height >> 8), MIRROR_TILE};
+        if (!pushFrame(hello, sizeof(hello))) {
+            return;
+        }
+        m_helloPending = false;
+    }
+
+    // Bands round robin from where the last pass stopped, so a busy band cannot starve the rest
+    for (int checked = 0; checked < m_rows; checked++) {
+        int row = m_nextRow;
+        auto first = m_dirty.begin() + row * m_columns;
+        if (std::find(first, first + m_columns, 1) == first + m_columns) {
+            m_nextRow = (row + 1) % m_rows;
+            continue;
+        }
+        if (!renderBand(row)) {
+            return;  // Queue full or a component there not drawn yet, retried next pass
+        }
+        m_nextRow = (row + 1) % m_rows;
+        if (micros() - startUs >= MIRROR_BUDGET_US) {
+            return;
+        }
+    }
+
+    // Everything damaged has been sent, the viewer can present
+    if (m_flushPending) {
+        uint8_t flush[] = {MIRROR_FRAME_TAG, (uint8_t)MirrorOp::Flush};
+        if (pushFrame(flush, sizeof(flush))) {
+            m_flushPending = false;
+        }
+    }
+}
+
+bool ScreenMirror::renderBand(int row) {
+    const uint8_t* flags = &m_dirty[row * m_columns];
+    int column0 = 0;
+    while (!flags[column0]) {
+        column0++;
+    }
+    int column1 = m_columns - 1;
+    while (!flags[column1]) {
+        column1--;
+    }
+
+    int x = column0 * MIRROR_TILE;
+    int y = row * MIRROR_TILE;
+    Rectangle region(x, y, std::min((column1 + 1) * MIRROR_TILE, m_gui.getWidth()) - x, std::min(MIRROR_TILE, m_gui.getHeight() - y));
+    m_rendering = true;
+    bool rendered = m_gui.renderRegion(m_strip, region);
+    m_rendering = false;
+    if (!rendered || !sendPalette()) {
+        return false;
+    }
+
+    for (int column = column0; column <= column1; column++) {
+        if (m_dirty[row * m_columns + column]) {
+            if (!sendTile(column, row, (column - column0) * MIRROR_TILE)) {
+                return false;
+            }
+            m_dirty[row * m_columns + column] = 0;
+        }
+    }
+    return true;
+}
+
+bool ScreenMirror::sendPalette() {
+    uint16_t count = m_strip.getPaletteCount();
+    bool changed = count != m_sentPaletteCount;
+    for (uint16_t i = 0; i < count && !changed; i++) {
+        changed = m_strip.colorOf(i) != m_sentPalette[i];
+    }
+    if (!changed) {
+        return true;
+    }
+
+    uint8_t frame[4 + 2 * 16] = {MIRROR_FRAME_TAG, (uint8_t)MirrorOp::Palette, 0, (uint8_t)count};
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t color = m_strip.colorOf(i);
+        frame[4 + i * 2] = (uint8_t)color;
+        frame[5 + i * 2] = (uint8_t)(color >> 8);
+    }
+    if (!pushFrame(frame, 4 + count * 2)) {
+        return false;
+    }
+
+    // Other themes map indices to other colors, what the viewer holds is stale
+    if (m_sentPaletteCount > 0) {
+        std::fill(m_tileHashes.begin(), m_tileHashes.end(), 0);
+        std::fill(m_dirty.begin(), m_dirty.end(), 1);
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        m_sentPalette[i] = m_strip.colorOf(i);
+    }
+    m_sentPaletteCount = count;
+    return true;
+}
+
+bool ScreenMirror::sendTile(int column, int row, int stripX) {
+    int width = std::min(MIRROR_TILE, m_gui.getWidth() - column * MIRROR_TILE);
+    int height = std::min(MIRROR_TILE, m_gui.getHeight() - row * MIRROR_TILE);
+
+    // Run-length code the tile and hash it on the way
+    uint8_t runs[MIRROR_TILE * MIRROR_TILE];
+    int runCount = 0;
+    uint32_t hash = 2166136261u;
+    uint8_t current = m_strip.indexAt(stripX, 0);
+    int length = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t index = m_strip.indexAt(stripX + x, y);
+            hash = (hash ^ index) * 16777619u;
+            if (index != current || length == 16) {
+                runs[runCount++] = (uint8_t)((length - 1) << 4 | current);
+                current = index;
+                length = 0;
+            }
+            length++;
+        }
+    }
+    runs[runCount++] = (uint8_t)((length - 1) << 4 | current);
+    hash = hash != 0 ? hash : 1;
+
+    uint32_t& sent = m_tileHashes[row * m_columns + column];
+    if (hash == sent) {
+        m_tilesUnchanged++;
+        return true;
+    }
+
+    // All frames of a tile or none, one slot stays free for the flush
+    size_t frames = (runCount + MIRROR_RUNS_PER_FRAME - 1) / MIRROR_RUNS_PER_FRAME;
+    if (BulkQueue::capacity() - m_queue.size() < frames + 1) {
+        return false;
+    }
+
+    int pixel = 0;
+    for (int first = 0; first < runCount; first += MIRROR_RUNS_PER_FRAME) {
+        int count = std::min(MIRROR_RUNS_PER_FRAME, runCount - first);
+        uint8_t frame[BULK_FRAME_BYTES] = {MIRROR_FRAME_TAG, (uint8_t)MirrorOp::Tile, (uint8_t)column, (uint8_t)row, (uint8_t)pixel};
+        memcpy(frame + MIRROR_TILE_HEADER, runs + first, count);
+        pushFrame(frame, MIRROR_TILE_HEADER + count);
+        for (int i = first; i < first + count; i++) {
+            pixel += (runs[i] >> 4) + 1;
+        }
+    }
+
+    sent = hash;
+    m_tilesSent++;
+    m_flushPending = true;
+    return true;
+}
+
+bool ScreenMirror::pushFrame(const uint8_t* data, uint8_t length) {
+    BulkFrame frame;
+    frame.length = length;
+    memcpy(frame.data, data, length);
+    if (!m_queue.push(frame)) {
+        return false;
+    }
+    m_bytesQueued += length;
+    return true;
+}
+
+void ScreenMirror::report(Print& out) const {
+    size_t pending = std::count(m_dirty.begin(), m_dirty.end(), 1);
+    out.printf("[mirror] %s, %u tiles sent, %u unchanged, %u bytes queued, %u tiles pending\n", m_running ? "running" : "stopped",
+               m_tilesSent, m_tilesUnchanged, m_bytesQueued, (unsigned)pending);
+}
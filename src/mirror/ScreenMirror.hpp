@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+
+#include <vector>
+
+#include "Arduino.h"
+#include "MirrorFormat.hpp"
+#include "../GUI/GuiManager.hpp"
+#include "../GUI/PaletteBuffer.hpp"
+#include "../comm/messages.hpp"
+
+#define MIRROR_INTERVAL_MS 50  // Between passes over the damaged tiles
+#define MIRROR_BUDGET_US 2000  // Rendering and encoding time per pass
+
+// Streams the changed parts of the screen to the host. Damage reported by the
+// GUI marks 16x16 tiles; each pass re-renders one band of damaged tiles into a
+// 4 bpp strip from the component tree (the panel is never read back), hashes
+// the tiles and run-length codes those that differ from what was last sent.
+// Passes are short and spaced out, and the frames go out through CommLink's
+// rate-limited bulk queue, so the UI keeps its frame time and the mixer
+// protocol its bandwidth. Content drawn directly on the panel outside
+// components (calibration, GuiManager::print) is not mirrored.
+class ScreenMirror {
+   public:
+    ScreenMirror(GuiManager& gui, BulkQueue& queue);
+    ~ScreenMirror();
+
+    // Starting allocates the strip and tile state (~3 KB); every call, also while
+    // running, resends the hello and the whole screen
+    bool start();
+    void stop();
+    bool isRunning() const;
+
+    // GUI damage, install with setDamageHandler()
+    void damage(const Rectangle& area);
+
+    // One pass when due, call from the UI loop after GuiManager::update()
+    void update(uint32_t nowMs);
+
+    void report(Print& out) const;
+
+   private:
+    GuiManager& m_gui;
+    BulkQueue& m_queue;
+    PaletteBuffer m_strip;
+    bool m_running;
+    bool m_rendering;  // Strip renders report damage too, ignored
+    int m_columns;
+    int m_rows;
+    int m_nextRow;
+    uint32_t m_nextMs;
+    bool m_helloPending;
+    bool m_flushPending;
+    std::vector<uint32_t> m_tileHashes;  // Of the content last sent, 0 = unknown
+    std::vector<uint8_t> m_dirty;        // One flag per tile
+    uint16_t m_sentPalette[16];
+    uint16_t m_sentPaletteCount;
+
+    uint32_t m_tilesSent;
+    uint32_t m_tilesUnchanged;
+    uint32_t m_bytesQueued;
+
+    bool renderBand(int row);
+    bool sendPalette();
+    bool sendTile(int column, int row, int stripX);
+    bool pushFrame(const uint8_t* data, uint8_t length);
+};
@@ -0,0 +1,68 @@
+#include "MixerModel.hpp"
+
+#include <string.h>
+
+MixerModel::MixerModel() {
+    memset(m_sessions, 0, sizeof(m_sessions));
+}
+
+uint8_t MixerModel::apply(const MixerMessage& message) {
+    if (message.session >= MAX_SESSIONS) {
+        return 0;
+    }
+
+    MixerSession next = m_sessions[message.session];
+    switch (message.type) {
+        case MessageType::SessionAdded:
+            next.active = true;
+            next.volume = message.value;
+            next.muted = false;
+            strncpy(next.name, message.text, MESSAGE_TEXT_LEN - 1);
+            next.name[MESSAGE_TEXT_LEN - 1] = '\0';
+            break;
+        case MessageType::SessionRemoved:
+            next.active = false;
+            break;
+        case MessageType::SessionVolume:
+            next.volume = message.value;
+            break;
+        case MessageType::SessionMute:
+            next.muted = message.value != 0;
+            break;
+        case MessageType::SessionName:
+            strncpy(next.name, message.text, MESSAGE_TEXT_LEN - 1);
+            next.name[MESSAGE_TEXT_LEN - 1] = '\0';
+            break;
+        default:
+            return 0;
+    }
+    return setSession(message.session, next);
+}
+
+uint8_t MixerModel::setSession(uint8_t index, const MixerSession& session) {
+    if (index >= MAX_SESSIONS) {
+        return 0;
+    }
+
+    MixerSession& current = m_sessions[index];
+    uint8_t changed = 0;
+    if (current.active != session.active) changed |= FIELD_PRESENCE;
+    if (current.volume != session.volume) changed |= FIELD_VOLUME;
+    if (current.muted != session.muted) changed |= FIELD_MUTE;
+    if (strncmp(current.name, session.name, MESSAGE_TEXT_LEN) != 0) changed |= FIELD_NAME;
+
+    current = session;
+    return changed;
+}
+
+const MixerSession& MixerModel::getSession(uint8_t index) const {
+    return m_sessions[index < MAX_SESSIONS ? index : 0];
+}
+
+uint8_t MixerModel::getSessionCount() const {
+    uint8_t count = 0;
+    for (const auto& session : m_sessions) {
+        if (session.active) count++;
+    }
+    return count;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <stdint.h>
+
+#include "../comm/messages.hpp"
+
+#define MAX_SESSIONS 8
+
+// Change mask bits reported per session
+#define FIELD_PRESENCE 0x01
+#define FIELD_VOLUME 0x02
+#define FIELD_MUTE 0x04
+#define FIELD_NAME 0x08
+#define FIELD_ALL 0x0F
+
+struct MixerSession {
+    bool active;
+    bool muted;
+    int16_t volume;  // 0..100
+    char name[MESSAGE_TEXT_LEN];
+};
+
+// Last known host mixer state. Only touched from the UI task, so it needs no locking.
+class MixerModel {
+   public:
+    MixerModel();
+
+    // Apply a host update, returns the FIELD_* bits that actually changed
+    uint8_t apply(const MixerMessage& message);
+
+    // Replace a session wholesale (snapshots), returns the FIELD_* bits that changed
+    uint8_t setSession(uint8_t index, const MixerSession& session);
+
+    const MixerSession& getSession(uint8_t index) const;
+    uint8_t getSessionCount() const;
+
+   private:
+    MixerSession m_sessions[MAX_SESSIONS];
+};
@@ -0,0 +1,31 @@
+#include "ModelBindings.hpp"
+
+ModelBindings::ModelBindings() : m_count(0) {
+}
+
+bool ModelBindings::bind(Component* component, uint8_t session, uint8_t fields) {
+    if (component == nullptr || m_count >= MAX_MODEL_BINDINGS) {
+        return false;
+    }
+    m_bindings[m_count++] = {component, session, fields};
+    return true;
+}
+
+void ModelBindings::unbind(Component* component) {
+    for (uint8_t i = 0; i < m_count;) {
+        if (m_bindings[i].component == component) {
+            m_bindings[i] = m_bindings[--m_count];
+        } else {
+            i++;
+        }
+    }
+}
+
+void ModelBindings::notify(uint8_t session, uint8_t fields) {
+    for (uint8_t i = 0; i < m_count; i++) {
+        const Binding& binding = m_bindings[i];
+        if (binding.session == session && (binding.fields & fields) != 0) {
+            binding.component->markDirty();
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+
+#include "../GUI/component.hpp"
+
+#define MAX_MODEL_BINDINGS 32
+
+// Which components show which session fields. Model changes mark only the
+// bound components dirty instead of the whole screen.
+class ModelBindings {
+   public:
+    ModelBindings();
+
+    bool bind(Component* component, uint8_t session, uint8_t fields);
+    void unbind(Component* component);
+
+    void notify(uint8_t session, uint8_t fields);
+
+   private:
+    struct Binding {
+        Component* component;
+        uint8_t session;
+        uint8_t fields;
+    };
+
+    Binding m_bindings[MAX_MODEL_BINDINGS];
+    uint8_t m_count;
+};
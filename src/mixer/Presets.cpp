@@ -0,0 +1,106 @@
+#include "Presets.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../log/Log.hpp"
+
+static const Preset DEFAULT_PRESETS[MAX_PRESETS] = {
+    {"meeting", 4, {{"Zoom", 100, false}, {"Teams", 100, false}, {"Discord", 80, false}, {PRESET_ANY_SESSION, 15, false}}},
+    {"gaming", 3, {{"Discord", 70, false}, {"Spotify", 30, false}, {PRESET_ANY_SESSION, 80, false}}},
+    {"music", 2, {{"Spotify", 80, false}, {PRESET_ANY_SESSION, 30, true}}},
+};
+
+PresetBank::PresetBank(MixerModel& model, StateSync& sync) : m_model(model), m_sync(sync) {
+    memcpy(m_presets, DEFAULT_PRESETS, sizeof(m_presets));
+}
+
+void PresetBank::load() {
+    m_preferences.begin("presets", true);
+    for (uint8_t i = 0; i < MAX_PRESETS; i++) {
+        char key[4];
+        snprintf(key, sizeof(key), "p%u", i);
+        Preset saved;
+        if (m_preferences.getBytes(key, &saved, sizeof(saved)) == sizeof(saved) && saved.count <= MAX_SESSIONS) {
+            m_presets[i] = saved;
+        }
+    }
+    m_preferences.end();
+}
+
+bool PresetBank::save(uint8_t index) {
+    if (index >= MAX_PRESETS) {
+        return false;
+    }
+
+    Preset& preset = m_presets[index];
+    preset.count = 0;
+    for (uint8_t i = 0; i < MAX_SESSIONS; i++) {
+        const MixerSession& session = m_model.getSession(i);
+        if (session.active) {
+            PresetEntry& entry = preset.entries[preset.count++];
+            memcpy(entry.session, session.name, MESSAGE_TEXT_LEN);
+            entry.volume = session.volume;
+            entry.muted = session.muted;
+        }
+    }
+
+    // Written on request only, never from the fader path
+    char key[4];
+    snprintf(key, sizeof(key), "p%u", index);
+    m_preferences.begin("presets", false);
+    bool stored = m_preferences.putBytes(key, &preset, sizeof(preset)) == sizeof(preset);
+    m_preferences.end();
+    if (!stored) {
+        LOG_E("Presets: could not store %s", preset.name);
+    }
+    return stored;
+}
+
+bool PresetBank::apply(uint8_t index) {
+    if (index >= MAX_PRESETS) {
+        return false;
+    }
+
+    const Preset& preset = m_presets[index];
+    MixerSession next[MAX_SESSIONS];
+    uint8_t sessions = 0;
+    for (uint8_t i = 0; i < MAX_SESSIONS; i++) {
+        next[i] = m_model.getSession(i);
+        const PresetEntry* entry = next[i].active ? findEntry(preset, next[i].name) : nullptr;
+        if (entry != nullptr && (entry->volume != next[i].volume || entry->muted != next[i].muted)) {
+            next[i].volume = entry->volume;
+            next[i].muted = entry->muted;
+            sessions |= 1 << i;
+        }
+    }
+
+    if (!m_sync.applyBatch(next, sessions)) {
+        LOG_W("Presets: %s not applied, host queue full", preset.name);
+        return false;
+    }
+    LOG_I("Presets: %s applied", preset.name);
+    return true;
+}
+
+uint8_t PresetBank::getCount() const {
+    return MAX_PRESETS;
+}
+
+const Preset& PresetBank::get(uint8_t index) const {
+    return m_presets[index < MAX_PRESETS ? index : 0];
+}
+
+const PresetEntry* PresetBank::findEntry(const Preset& preset, const char* session) const {
+    const PresetEntry* any = nullptr;
+    for (uint8_t i = 0; i < preset.count; i++) {
+        const PresetEntry& entry = preset.entries[i];
+        if (strncmp(entry.session, session, MESSAGE_TEXT_LEN) == 0) {
+            return &entry;
+        }
+        if (strcmp(entry.session, PRESET_ANY_SESSION) == 0) {
+            any = &entry;
+        }
+    }
+    return any;
+}
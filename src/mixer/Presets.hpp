@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+
+#include <Preferences.h>
+
+#include "MixerModel.hpp"
+#include "StateSync.hpp"
+
+#define MAX_PRESETS 3
+#define PRESET_NAME_LEN 12
+#define PRESET_ANY_SESSION "*"  // Entry for the sessions no other entry names
+
+struct PresetEntry {
+    char session[MESSAGE_TEXT_LEN];  // Matched against session names, slots change between runs
+    int16_t volume;
+    bool muted;
+};
+
+struct Preset {
+    char name[PRESET_NAME_LEN];
+    uint8_t count;
+    PresetEntry entries[MAX_SESSIONS];
+};
+
+// Named volume and mute settings for the running sessions ("meeting",
+// "gaming", "music"), kept in NVS. Applying one is a single StateSync batch:
+// every affected session changes in the same frame and the host receives one
+// message, instead of a volume event and a redraw per session.
+class PresetBank {
+   public:
+    PresetBank(MixerModel& model, StateSync& sync);
+
+    // Saved presets, built-in defaults for slots never saved
+    void load();
+
+    // Replaces a preset with the volumes and mutes of the active sessions and stores it
+    bool save(uint8_t index);
+
+    bool apply(uint8_t index);
+
+    uint8_t getCount() const;
+    const Preset& get(uint8_t index) const;
+
+   private:
+    MixerModel& m_model;
+    StateSync& m_sync;
+    Preset m_presets[MAX_PRESETS];
+    Preferences m_preferences;
+
+    const PresetEntry* findEntry(const Preset& preset, const char* session) const;
+};
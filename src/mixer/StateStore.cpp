@@ -0,0 +1,276 @@
+#include "StateStore.hpp"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../log/Log.hpp"
+
+#define STORE_SECTOR_MAGIC 0x31534D55  // "UMS1"
+#define STORE_RECORD_MARKER 0x5A
+#define STORE_FLAG_ACTIVE 0x01
+#define STORE_FLAG_MUTED 0x02
+
+// Slot 0 of every sector, written last when a sector is started
+struct SectorHeader {
+    uint32_t magic;
+    uint32_t generation;  // Higher is newer
+    uint16_t crc;
+    uint8_t unused[STORE_SLOT_BYTES - 10];
+};
+
+// One session's saved state, later records override earlier ones
+struct SessionRecord {
+    uint8_t marker;  // STORE_RECORD_MARKER, 0xFF is free space
+    uint8_t session;
+    uint8_t flags;
+    uint8_t reserved;
+    int16_t volume;
+    uint16_t crc;  // Over the record with this field zero, a torn write fails it
+    char name[MESSAGE_TEXT_LEN];
+};
+
+static_assert(sizeof(SectorHeader) == STORE_SLOT_BYTES, "header must fill one slot");
+static_assert(sizeof(SessionRecord) == STORE_SLOT_BYTES, "record must fill one slot");
+
+static uint16_t crc16(const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)bytes[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint16_t headerCrc(SectorHeader header) {
+    header.crc = 0;
+    return crc16(&header, offsetof(SectorHeader, unused));
+}
+
+static uint16_t recordCrc(SessionRecord record) {
+    record.crc = 0;
+    return crc16(&record, sizeof(record));
+}
+
+StateStore::StateStore(FlashRegion& flash)
+    : m_flash(flash),
+      m_dirty(0),
+      m_firstDirtyMs(0),
+      m_lastDirtyMs(0),
+      m_sectorCount(0),
+      m_sector(0),
+      m_generation(0),
+      m_slot(STORE_SLOTS_PER_SECTOR),
+      m_recordsWritten(0),
+      m_compactions(0),
+      m_errors(0) {
+}
+
+bool StateStore::load(MixerModel& model) {
+    if (!m_flash.begin()) {
+        LOG_E("StateStore: flash region not found");
+        return false;
+    }
+    m_sectorCount = m_flash.size() / FLASH_SECTOR_SIZE;
+    if (m_sectorCount < 2) {
+        LOG_E("StateStore: flash region needs at least two sectors");
+        return false;
+    }
+
+    // The newest complete sector holds the whole state
+    bool found = false;
+    for (uint32_t sector = 0; sector < m_sectorCount; sector++) {
+        SectorHeader header;
+        if (!m_flash.read(sector * FLASH_SECTOR_SIZE, &header, sizeof(header)) || header.magic != STORE_SECTOR_MAGIC ||
+            header.crc != headerCrc(header)) {
+            continue;
+        }
+        if (!found || header.generation > m_generation) {
+            found = true;
+            m_sector = sector;
+            m_generation = header.generation;
+        }
+    }
+    if (!found) {
+        // Blank region: the first save starts sector 0
+        m_sector = m_sectorCount - 1;
+        m_slot = STORE_SLOTS_PER_SECTOR;
+        return false;
+    }
+
+    MixerSession sessions[MAX_SESSIONS];
+    memset(sessions, 0, sizeof(sessions));
+    m_slot = 1;
+    for (uint32_t slot = 1; slot < STORE_SLOTS_PER_SECTOR; slot++) {
+        SessionRecord record;
+        if (!m_flash.read(m_sector * FLASH_SECTOR_SIZE + slot * STORE_SLOT_BYTES, &record, sizeof(record)) ||
+            record.marker == 0xFF) {
+            break;
+        }
+        m_slot = slot + 1;  // Appends go after torn records too, never over them
+        if (record.marker != STORE_RECORD_MARKER || record.crc != recordCrc(record) || record.session >= MAX_SESSIONS) {
+            continue;
+        }
+
+        MixerSession& session = sessions[record.session];
+        session.active = (record.flags & STORE_FLAG_ACTIVE) != 0;
+        session.muted = (record.flags & STORE_FLAG_MUTED) != 0;
+        session.volume = record.volume;
+        memcpy(session.name, record.name, MESSAGE_TEXT_LEN);
+        session.name[MESSAGE_TEXT_LEN - 1] = '\0';
+    }
+
+    for (uint8_t i = 0; i < MAX_SESSIONS; i++) {
+        model.setSession(i, sessions[i]);
+    }
+    LOG_I("StateStore: %u sessions from sector %u, generation %u", model.getSessionCount(), m_sector, m_generation);
+    return true;
+}
+
+#ifdef ARDUINO
+void StateStore::start(BaseType_t core) {
+    xTaskCreatePinnedToCore(StateStore::taskEntry, "store", STORE_TASK_STACK, this, STORE_TASK_PRIORITY, &m_task, core);
+}
+
+TaskHandle_t StateStore::getTask() const {
+    return m_task;
+}
+
+void StateStore::taskEntry(void* arg) {
+    StateStore* store = static_cast<StateStore*>(arg);
+    for (;;) {
+        store->service();
+        vTaskDelay(pdMS_TO_TICKS(STORE_POLL_MS));
+    }
+}
+#endif
+
+void StateStore::markDirty(uint8_t session, uint8_t fields, uint32_t nowMs) {
+    if (session >= MAX_SESSIONS || (fields & (FIELD_PRESENCE | FIELD_VOLUME | FIELD_MUTE | FIELD_NAME)) == 0) {
+        return;
+    }
+    if (m_dirty == 0) {
+        m_firstDirtyMs = nowMs;
+    }
+    m_dirty |= 1 << session;
+    m_lastDirtyMs = nowMs;
+}
+
+void StateStore::update(const MixerModel& model, uint32_t nowMs) {
+    if (m_sectorCount < 2) {
+        m_dirty = 0;  // No usable region, nothing is saved
+        return;
+    }
+    if (m_dirty == 0 || (nowMs - m_lastDirtyMs < STORE_QUIET_MS && nowMs - m_firstDirtyMs < STORE_MAX_DELAY_MS)) {
+        return;
+    }
+
+    StoreBatch batch;
+    batch.sessions = m_dirty;
+    for (uint8_t i = 0; i < MAX_SESSIONS; i++) {
+        batch.state[i] = model.getSession(i);
+    }
+    if (m_queue.push(batch)) {
+        m_dirty = 0;  // Otherwise the flash task is behind, retried next frame
+    }
+}
+
+void StateStore::service() {
+    StoreBatch batch;
+    while (m_queue.pop(batch)) {
+        writeBatch(batch);
+    }
+}
+
+void StateStore::writeBatch(const StoreBatch& batch) {
+    uint32_t needed = 0;
+    for (uint8_t i = 0; i < MAX_SESSIONS; i++) {
+        needed += (batch.sessions >> i) & 1;
+    }
+    if (m_slot + needed > STORE_SLOTS_PER_SECTOR) {
+        if (!compact(batch)) {
+            m_errors++;
+            LOG_E("StateStore: compaction into sector %u failed", (m_sector + 1) % m_sectorCount);
+        }
+        return;  // The new sector starts with the whole state, batch included
+    }
+
+    for (uint8_t i = 0; i < MAX_SESSIONS; i++) {
+        if (((batch.sessions >> i) & 1) && !writeRecord(m_sector, m_slot++, i, batch.state[i])) {
+            m_errors++;
+        }
+    }
+}
+
+bool StateStore::compact(const StoreBatch& batch) {
+    uint32_t next = (m_sector + 1) % m_sectorCount;
+    if (!m_flash.eraseSector(next)) {
+        return false;
+    }
+
+    uint32_t slot = 1;
+    for (uint8_t i = 0; i < MAX_SESSIONS; i++) {
+        if (batch.state[i].active && !writeRecord(next, slot++, i, batch.state[i])) {
+            return false;
+        }
+    }
+
+    // The header makes the sector the newest, only once everything is in it
+    SectorHeader header;
+    memset(&header, 0xFF, sizeof(header));
+    header.magic = STORE_SECTOR_MAGIC;
+    header.generation = m_generation + 1;
+    header.crc = headerCrc(header);
+    if (!m_flash.write(next * FLASH_SECTOR_SIZE, &header, sizeof(header))) {
+        return false;
+    }
+
+    m_sector = next;
+    m_generation = header.generation;
+    m_slot = slot;
+    m_compactions++;
+    return true;
+}
+
+bool StateStore::writeRecord(uint32_t sector, uint32_t slot, uint8_t session, const MixerSession& state) {
+    SessionRecord record;
+    memset(&record, 0, sizeof(record));
+    record.marker = STORE_RECORD_MARKER;
+    record.session = session;
+    record.flags = (state.active ? STORE_FLAG_ACTIVE : 0) | (state.muted ? STORE_FLAG_MUTED : 0);
+    record.volume = state.volume;
+    memcpy(record.name, state.name, MESSAGE_TEXT_LEN);
+    record.crc = recordCrc(record);
+    m_recordsWritten++;
+    return m_flash.write(sector * FLASH_SECTOR_SIZE + slot * STORE_SLOT_BYTES, &record, sizeof(record));
+}
+
+uint32_t StateStore::getGeneration() const {
+    return m_generation;
+}
+
+uint32_t StateStore::getSector() const {
+    return m_sector;
+}
+
+uint32_t StateStore::getSectorCount() const {
+    return m_sectorCount;
+}
+
+uint32_t StateStore::getUsedSlots() const {
+    return m_slot;
+}
+
+uint32_t StateStore::getRecordsWritten() const {
+    return m_recordsWritten;
+}
+
+uint32_t StateStore::getCompactions() const {
+    return m_compactions;
+}
+
+uint32_t StateStore::getErrors() const {
+    return m_errors;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <stdint.h>
+
+#include "../comm/spsc_queue.hpp"
+#include "../storage/FlashRegion.hpp"
+#include "MixerModel.hpp"
+
+#ifdef ARDUINO
+#include "Arduino.h"
+#endif
+
+#define STORE_QUIET_MS 2000       // Changes are saved once the mixer has been still this long,
+#define STORE_MAX_DELAY_MS 10000  // or at the latest this long after the first unsaved change
+
+#define STORE_SLOT_BYTES 32
+#define STORE_SLOTS_PER_SECTOR (FLASH_SECTOR_SIZE / STORE_SLOT_BYTES)
+
+#define STORE_TASK_STACK 3072
+#define STORE_TASK_PRIORITY 1
+#define STORE_POLL_MS 100
+
+// Sessions changed since the last save, with the model as it was then
+struct StoreBatch {
+    uint8_t sessions;  // Bit per session
+    MixerSession state[MAX_SESSIONS];
+};
+
+using StoreQueue = SpscQueue<StoreBatch, 2>;
+
+// Last known mixer state in flash, so the model holds the sessions right after
+// a reboot while the host reconnects (no screen binds session fields yet).
+// The region is an append-only log of 32-byte session records in 4 KB sectors
+// used round robin. Filling a sector compacts into the next one: it is erased,
+// gets the current state of every active session and then its header, so a
+// reset at any point leaves either the old or the new sector complete. Erases
+// spread evenly over the region.
+//
+// The UI task only copies changed sessions into a queue, coalesced over
+// seconds; a low-priority task does the flash writes and erases.
+class StateStore {
+   public:
+    StateStore(FlashRegion& flash);
+
+    // Restores the sessions saved in the newest sector, false when there are none
+    bool load(MixerModel& model);
+
+#ifdef ARDUINO
+    void start(BaseType_t core = 0);
+    TaskHandle_t getTask() const;
+#endif
+
+    // UI task: note model changes, then queue a batch when the mixer settles
+    void markDirty(uint8_t session, uint8_t fields, uint32_t nowMs);
+    void update(const MixerModel& model, uint32_t nowMs);
+
+    // Writes queued batches; the task calls it in a loop, native tools call it directly
+    void service();
+
+    uint32_t getGeneration() const;
+    uint32_t getSector() const;
+    uint32_t getSectorCount() const;
+    uint32_t getUsedSlots() const;  // Of the current sector, header included
+    uint32_t getRecordsWritten() const;
+    uint32_t getCompactions() const;
+    uint32_t getErrors() const;
+
+   private:
+    FlashRegion& m_flash;
+    StoreQueue m_queue;
+
+    // UI task
+    uint8_t m_dirty;
+    uint32_t m_firstDirtyMs;
+    uint32_t m_lastDirtyMs;
+
+    // Flash task after load()
+    uint32_t m_sectorCount;
+    uint32_t m_sector;
+    uint32_t m_generation;
+    uint32_t m_slot;  // Next free record slot in the sector
+    uint32_t m_recordsWritten;
+    uint32_t m_compactions;
+    uint32_t m_errors;
+
+#ifdef ARDUINO
+    TaskHandle_t m_task = nullptr;
+    static void taskEntry(void* arg);
+#endif
+    void writeBatch(const StoreBatch& batch);
+    bool compact(const StoreBatch& batch);
+    bool writeRecord(uint32_t sector, uint32_t slot, uint8_t session, const MixerSession& state);
+};
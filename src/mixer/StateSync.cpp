@@ -0,0 +1,179 @@
+#include "StateSync.hpp"
+
+StateSync::StateSync(MixerModel& model)
+    : m_model(model),
+      m_state(State::Unsynced),
+      m_version(0),
+      m_ackedVersion(0),
+      m_snapshotVersion(0),
+      m_lastAckMs(0),
+      m_lastResyncMs(0),
+      m_snapshotStartMs(0),
+      m_gaps(0),
+      m_snapshotTimeouts(0),
+      m_pendingCount(0) {
+}
+
+void StateSync::begin(uint32_t nowMs) {
+    m_state = State::Unsynced;
+    requestResync(nowMs);
+}
+
+bool StateSync::isStateMessage(MessageType type) {
+    switch (type) {
+        case MessageType::SessionAdded:
+        case MessageType::SessionRemoved:
+        case MessageType::SessionVolume:
+        case MessageType::SessionMute:
+        case MessageType::SessionName:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void StateSync::handle(const MixerMessage& message, uint32_t nowMs) {
+    if (message.type == MessageType::SnapshotBegin) {
+        m_staging = MixerModel();
+        m_snapshotVersion = message.sequence;
+        m_snapshotStartMs = nowMs;
+        m_pendingCount = 0;
+        m_state = State::ReceivingSnapshot;
+        return;
+    }
+
+    if (message.type == MessageType::SnapshotEnd) {
+        if (m_state == State::ReceivingSnapshot && message.sequence == m_snapshotVersion) {
+            commitSnapshot(nowMs);
+        }
+        return;
+    }
+
+    if (!isStateMessage(message.type)) {
+        return;
+    }
+
+    if (m_state == State::ReceivingSnapshot) {
+        if (message.sequence == m_snapshotVersion) {
+            m_staging.apply(message);
+        } else if (message.sequence > m_snapshotVersion && m_pendingCount < SYNC_PENDING_DELTAS) {
+            m_pending[m_pendingCount++] = message;  // Newer than the snapshot, applied after it
+        }
+        return;  // Older deltas are already part of the snapshot, overflow shows as a gap later
+    }
+
+    applyDelta(message, nowMs);
+}
+
+void StateSync::applyDelta(const MixerMessage& message, uint32_t nowMs) {
+    if (m_state != State::Synced || message.sequence <= m_version) {
+        return;  // Waiting for a snapshot, or a duplicate
+    }
+
+    if (message.sequence != m_version + 1) {
+        // A delta went missing, the model can no longer be trusted
+        m_gaps++;
+        m_state = State::Unsynced;
+        requestResync(nowMs);
+        return;
+    }
+
+    m_version = message.sequence;
+    notify(message.session, m_model.apply(message));
+}
+
+void StateSync::update(uint32_t nowMs) {
+    if (m_state == State::ReceivingSnapshot && nowMs - m_snapshotStartMs >= SYNC_SNAPSHOT_TIMEOUT_MS) {
+        // SnapshotEnd or part of the snapshot was lost
+        m_snapshotTimeouts++;
+        m_state = State::Unsynced;
+        requestResync(nowMs);
+        return;
+    }
+
+    if (m_state == State::Unsynced && nowMs - m_lastResyncMs >= SYNC_RESYNC_RETRY_MS) {
+        requestResync(nowMs);
+        return;
+    }
+
+    if (m_state == State::Synced && m_version != m_ackedVersion && nowMs - m_lastAckMs >= SYNC_ACK_INTERVAL_MS && send) {
+        MixerMessage ack = {MessageType::Ack, 0, 0, m_version, {0}};
+        if (send(ack)) {
+            m_ackedVersion = m_version;
+            m_lastAckMs = nowMs;
+        }
+    }
+}
+
+bool StateSync::applyBatch(const MixerSession (&next)[MAX_SESSIONS], uint8_t sessions) {
+    static_assert(MAX_SESSIONS <= 8 && MAX_SESSIONS <= MESSAGE_TEXT_LEN, "SetSessions carries sessions as bits and bytes");
+    if (sessions == 0) {
+        return true;
+    }
+
+    MixerMessage batch = {MessageType::SetSessions, sessions, 0, 0, {0}};
+    for (uint8_t i = 0; i < MAX_SESSIONS; i++) {
+        if ((sessions >> i) & 1) {
+            batch.value |= next[i].muted ? 1 << i : 0;
+            batch.text[i] = (char)next[i].volume;
+        }
+    }
+    if (!send || !send(batch)) {
+        return false;
+    }
+
+    // The host confirms with deltas carrying the same values, those change nothing on screen
+    for (uint8_t i = 0; i < MAX_SESSIONS; i++) {
+        if ((sessions >> i) & 1) {
+            notify(i, m_model.setSession(i, next[i]));
+        }
+    }
+    return true;
+}
+
+bool StateSync::isSynced() const {
+    return m_state == State::Synced;
+}
+
+uint32_t StateSync::getVersion() const {
+    return m_version;
+}
+
+uint32_t StateSync::getGapCount() const {
+    return m_gaps;
+}
+
+uint32_t StateSync::getSnapshotTimeoutCount() const {
+    return m_snapshotTimeouts;
+}
+
+void StateSync::requestResync(uint32_t nowMs) {
+    m_lastResyncMs = nowMs;
+    if (send) {
+        MixerMessage request = {MessageType::ResyncRequest, 0, 0, m_version, {0}};
+        send(request);
+    }
+}
+
+void StateSync::commitSnapshot(uint32_t nowMs) {
+    // Diff against the current model so unchanged sessions stay clean on screen
+    for (uint8_t i = 0; i < MAX_SESSIONS; i++) {
+        notify(i, m_model.setSession(i, m_staging.getSession(i)));
+    }
+    m_version = m_snapshotVersion;
+    m_ackedVersion = m_version - 1;  // Acknowledge the snapshot on the next update
+    m_state = State::Synced;
+
+    // A gap among them requests the next snapshot as usual
+    uint8_t pending = m_pendingCount;
+    m_pendingCount = 0;
+    for (uint8_t i = 0; i < pending && m_state == State::Synced; i++) {
+        applyDelta(m_pending[i], nowMs);
+    }
+}
+
+void StateSync::notify(uint8_t session, uint8_t fields) {
+    if (fields != 0 && onChange) {
+        onChange(session, fields);
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <stdint.h>
+
+#include "../delegate.hpp"
+#include "MixerModel.hpp"
+
+#define SYNC_ACK_INTERVAL_MS 50
+#define SYNC_RESYNC_RETRY_MS 1000
+#define SYNC_SNAPSHOT_TIMEOUT_MS 2000  // A snapshot still incomplete after this is given up and requested again
+#define SYNC_PENDING_DELTAS 16         // Deltas newer than the snapshot kept while it arrives
+
+using ChangeHandler = Delegate<void(uint8_t session, uint8_t fields)>;
+using SendHandler = Delegate<bool(const MixerMessage&)>;
+
+// Keeps MixerModel in step with the host. The host sends a full snapshot
+// (SnapshotBegin, SessionAdded/SessionMute..., SnapshotEnd, all carrying the
+// snapshot version) and then deltas numbered version + 1, + 2, ... A missing
+// number means a lost delta: the model stops accepting deltas and asks for a
+// new snapshot. Deltas the host sends while its snapshot is still arriving are
+// held back and applied after it, so continuous changes (a fader drag) do not
+// turn every resync into the next gap. The last applied version is
+// acknowledged, rate-limited.
+class StateSync {
+   public:
+    StateSync(MixerModel& model);
+
+    // Start unsynced and ask the host for a snapshot
+    void begin(uint32_t nowMs);
+
+    void handle(const MixerMessage& message, uint32_t nowMs);
+
+    // Per frame: acks, resync retries and snapshot timeouts
+    void update(uint32_t nowMs);
+
+    // A local change of several sessions at once, such as a preset: the model
+    // takes all of it in one step and the host gets one SetSessions message.
+    // Nothing changes when the message cannot be queued.
+    bool applyBatch(const MixerSession (&next)[MAX_SESSIONS], uint8_t sessions);
+
+    bool isSynced() const;
+    uint32_t getVersion() const;
+    uint32_t getGapCount() const;
+    uint32_t getSnapshotTimeoutCount() const;
+
+    ChangeHandler onChange;  // Per session, with the FIELD_* bits that changed
+    SendHandler send;
+
+   private:
+    enum class State : uint8_t {
+        Unsynced,
+        ReceivingSnapshot,
+        Synced
+    };
+
+    MixerModel& m_model;
+    MixerModel m_staging;  // Snapshot being received, committed on SnapshotEnd
+    State m_state;
+    uint32_t m_version;
+    uint32_t m_ackedVersion;
+    uint32_t m_snapshotVersion;
+    uint32_t m_lastAckMs;
+    uint32_t m_lastResyncMs;
+    uint32_t m_snapshotStartMs;
+    uint32_t m_gaps;
+    uint32_t m_snapshotTimeouts;
+    MixerMessage m_pending[SYNC_PENDING_DELTAS];
+    uint8_t m_pendingCount;
+
+    void applyDelta(const MixerMessage& message, uint32_t nowMs);
+    void requestResync(uint32_t nowMs);
+    void commitSnapshot(uint32_t nowMs);
+    void notify(uint8_t session, uint8_t fields);
+    static bool isStateMessage(MessageType type);
+};
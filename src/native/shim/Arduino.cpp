@@ -0,0 +1,27 @@
+#ifndef ARDUINO
+#include "Arduino.h"
+
+HardwareSerial Serial;
+
+static unsigned long s_nowMs = 0;
+
+unsigned long millis() {
+    return s_nowMs;
+}
+
+unsigned long micros() {
+    return s_nowMs * 1000UL;
+}
+
+void delay(unsigned long ms) {
+    s_nowMs += ms;
+}
+
+void nativeSetMillis(unsigned long ms) {
+    s_nowMs = ms;
+}
+
+void nativeAdvanceMillis(unsigned long ms) {
+    s_nowMs += ms;
+}
+#endif
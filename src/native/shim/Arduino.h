@@ -0,0 +1,116 @@
+#pragma once
+// Minimal Arduino API for host builds (env:native*). Time is virtual and only
+// moves when the host program advances it, so replays are deterministic.
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define FALLING 2
+#define IRAM_ATTR
+#define PROGMEM
+
+class String {
+   public:
+    String() {}
+    String(const char* text) : m_value(text != nullptr ? text : "") {}
+    String(const std::string& text) : m_value(text) {}
+    String(char c) : m_value(1, c) {}
+    String(int value) : m_value(std::to_string(value)) {}
+    String(unsigned int value) : m_value(std::to_string(value)) {}
+    String(long value) : m_value(std::to_string(value)) {}
+    String(unsigned long value) : m_value(std::to_string(value)) {}
+
+    const char* c_str() const { return m_value.c_str(); }
+    unsigned int length() const { return m_value.size(); }
+    char operator[](unsigned int index) const { return m_value[index]; }
+    String& operator+=(const String& other) { m_value += other.m_value; return *this; }
+    String operator+(const String& other) const { return String(m_value + other.m_value); }
+    bool operator==(const String& other) const { return m_value == other.m_value; }
+    bool operator!=(const String& other) const { return m_value != other.m_value; }
+
+   private:
+    std::string m_value;
+};
+
+class Print {
+   public:
+    virtual ~Print() = default;
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length; i++) write(data[i]);
+        return length;
+    }
+
+    size_t print(const char* text) { return write(reinterpret_cast<const uint8_t*>(text), strlen(text)); }
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value) { return printf("%d", value); }
+    size_t print(unsigned int value) { return printf("%u", value); }
+    size_t print(long value) { return printf("%ld", value); }
+    size_t print(unsigned long value) { return printf("%lu", value); }
+    size_t print(double value) { return printf("%.2f", value); }
+
+    size_t println() { return print("\r\n"); }
+    template <typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        if (length < 0) return 0;
+        return write(reinterpret_cast<const uint8_t*>(buffer), std::min<size_t>(length, sizeof(buffer) - 1));
+    }
+};
+
+class Stream : public Print {
+   public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+};
+
+// Discards output unless echo is enabled, so runner output stays readable
+class HardwareSerial : public Stream {
+   public:
+    void begin(unsigned long) {}
+    void setEcho(bool echo) { m_echo = echo; }
+    size_t write(uint8_t c) override {
+        if (m_echo) fputc(c, stderr);
+        return 1;
+    }
+    using Print::write;
+    operator bool() const { return true; }
+
+   private:
+    bool m_echo = false;
+};
+
+extern HardwareSerial Serial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+// Virtual clock control for host programs
+void nativeSetMillis(unsigned long ms);
+void nativeAdvanceMillis(unsigned long ms);
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return HIGH; }
+inline int analogRead(int) { return 0; }
+inline int digitalPinToInterrupt(int pin) { return pin; }
+inline void attachInterrupt(int, void (*)(), int) {}
@@ -0,0 +1,215 @@
+#ifndef ARDUINO
+#include "LovyanGFX.hpp"
+
+namespace lgfx {
+
+void LovyanGFX::resize(int32_t width, int32_t height) {
+    m_width = width;
+    m_height = height;
+    clearClipRect();
+}
+
+void LovyanGFX::countWindow(uint64_t pixels) {
+    if (m_countBus) {
+        m_stats.windows++;
+        m_stats.pixels += pixels;
+    }
+}
+
+void LovyanGFX::setClipRect(int32_t x, int32_t y, int32_t w, int32_t h) {
+    int32_t x0 = std::max<int32_t>(0, x), y0 = std::max<int32_t>(0, y);
+    int32_t x1 = std::min(m_width, x + w), y1 = std::min(m_height, y + h);
+    m_clipX = x0;
+    m_clipY = y0;
+    m_clipW = std::max<int32_t>(0, x1 - x0);
+    m_clipH = std::max<int32_t>(0, y1 - y0);
+}
+
+void LovyanGFX::getClipRect(int32_t* x, int32_t* y, int32_t* w, int32_t* h) const {
+    *x = m_clipX;
+    *y = m_clipY;
+    *w = m_clipW;
+    *h = m_clipH;
+}
+
+void LovyanGFX::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    int32_t x0 = std::max(x, m_clipX), y0 = std::max(y, m_clipY);
+    int32_t x1 = std::min(x + w, m_clipX + m_clipW), y1 = std::min(y + h, m_clipY + m_clipH);
+    if (x1 <= x0 || y1 <= y0) {
+        return;
+    }
+
+    countWindow((uint64_t)(x1 - x0) * (y1 - y0));
+    for (int32_t py = y0; py < y1; py++) {
+        for (int32_t px = x0; px < x1; px++) {
+            storePixel(px, py, color);
+        }
+    }
+}
+
+void LovyanGFX::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    drawFastHLine(x, y, w, color);
+    if (h > 1) drawFastHLine(x, y + h - 1, w, color);
+    if (h > 2) {
+        drawFastVLine(x, y + 1, h - 2, color);
+        if (w > 1) drawFastVLine(x + w - 1, y + 1, h - 2, color);
+    }
+}
+
+uint32_t LovyanGFX::readPixelValue(int32_t x, int32_t y) const {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return 0;
+    }
+    return loadPixel(x, y);
+}
+
+void LovyanGFX::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+    m_windowX = x;
+    m_windowY = y;
+    m_windowW = std::max<int32_t>(0, w);
+    m_windowH = std::max<int32_t>(0, h);
+    m_windowPos = 0;
+    if (m_countBus) {
+        m_stats.windows++;
+    }
+}
+
+void LovyanGFX::writePixels(const uint16_t* data, int32_t length, bool) {
+    if (m_countBus) {
+        m_stats.pixels += length;
+    }
+    for (int32_t i = 0; i < length && m_windowPos < m_windowW * m_windowH; i++, m_windowPos++) {
+        int32_t px = m_windowX + m_windowPos % m_windowW;
+        int32_t py = m_windowY + m_windowPos / m_windowW;
+        if (px >= 0 && py >= 0 && px < m_width && py < m_height) {
+            storePixel(px, py, data[i]);
+        }
+    }
+}
+
+void LovyanGFX::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) {
+    setAddrWindow(x, y, w, h);
+    writePixels(data, w * h);
+}
+
+size_t LovyanGFX::write(uint8_t c) {
+    if (c == '\n') {
+        m_cursorX = 0;
+        m_cursorY += fontHeight();
+        return 1;
+    }
+    if (c == '\r') {
+        return 1;
+    }
+
+    // With a distinct background the whole cell is painted first, like LovyanGFX does
+    if (m_textBackground != m_textForeground) {
+        fillRect(m_cursorX, m_cursorY, 6 * m_textSize, 8 * m_textSize, m_textBackground);
+    }
+
+    // Deterministic 5x7 pattern per character, one block per set bit
+    uint32_t bits = c * 2654435761u;
+    for (int column = 0; column < 5; column++) {
+        for (int row = 0; row < 7; row++) {
+            if ((bits >> ((column * 7 + row) % 32)) & 1) {
+                fillRect(m_cursorX + column * m_textSize, m_cursorY + row * m_textSize, m_textSize, m_textSize, m_textForeground);
+            }
+        }
+    }
+    m_cursorX += 6 * m_textSize;
+    return 1;
+}
+
+LGFX_Device::LGFX_Device(int32_t panelWidth, int32_t panelHeight)
+    : m_panelWidth(panelWidth), m_panelHeight(panelHeight) {
+    m_countBus = true;
+    resize(panelWidth, panelHeight);
+    m_pixels.assign(panelWidth * panelHeight, 0);
+}
+
+bool LGFX_Device::init() {
+    std::fill(m_pixels.begin(), m_pixels.end(), 0);
+    return true;
+}
+
+void LGFX_Device::setRotation(uint8_t rotation) {
+    m_rotation = rotation & 3;
+    if (m_rotation & 1) {
+        resize(m_panelHeight, m_panelWidth);
+    } else {
+        resize(m_panelWidth, m_panelHeight);
+    }
+}
+
+uint32_t LGFX_Device::frameHash() const {
+    // FNV-1a over the visible pixels
+    uint32_t hash = 2166136261u;
+    for (uint16_t pixel : m_pixels) {
+        hash = (hash ^ (pixel & 0xFF)) * 16777619u;
+        hash = (hash ^ (pixel >> 8)) * 16777619u;
+    }
+    return hash;
+}
+
+void* LGFX_Sprite::createSprite(int32_t width, int32_t height) {
+    m_stride = m_depth == palette_4bit ? (width + 1) / 2 : width * (m_depth == palette_8bit ? 1 : 2);
+    m_buffer.assign((size_t)m_stride * height, 0);
+    resize(width, height);
+    return m_buffer.data();
+}
+
+void LGFX_Sprite::deleteSprite() {
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    resize(0, 0);
+}
+
+void LGFX_Sprite::setPaletteColor(size_t index, uint8_t r, uint8_t g, uint8_t b) {
+    if (index < 256) {
+        m_palette[index] = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    }
+}
+
+void LGFX_Sprite::storePixel(int32_t x, int32_t y, uint32_t value) {
+    uint8_t* line = m_buffer.data() + y * m_stride;
+    if (m_depth == palette_4bit) {
+        uint8_t& packed = line[x >> 1];
+        packed = (x & 1) ? (packed & 0xF0) | (value & 0x0F) : (packed & 0x0F) | ((value & 0x0F) << 4);
+    } else if (m_depth == palette_8bit) {
+        line[x] = value;
+    } else {
+        reinterpret_cast<uint16_t*>(line)[x] = value;
+    }
+}
+
+uint32_t LGFX_Sprite::loadPixel(int32_t x, int32_t y) const {
+    const uint8_t* line = m_buffer.data() + y * m_stride;
+    if (m_depth == palette_4bit) {
+        return (x & 1) ? (line[x >> 1] & 0x0F) : (line[x >> 1] >> 4);
+    }
+    if (m_depth == palette_8bit) {
+        return line[x];
+    }
+    return reinterpret_cast<const uint16_t*>(line)[x];
+}
+
+void LGFX_Sprite::pushSprite(LovyanGFX* target, int32_t x, int32_t y) {
+    if (m_buffer.empty() || target == nullptr) {
+        return;
+    }
+
+    std::vector<uint16_t> pixels(m_width * m_height);
+    for (int32_t py = 0; py < m_height; py++) {
+        for (int32_t px = 0; px < m_width; px++) {
+            uint32_t value = loadPixel(px, py);
+            pixels[py * m_width + px] = hasPalette() ? m_palette[value] : value;
+        }
+    }
+    target->pushImage(x, y, m_width, m_height, pixels.data());
+}
+
+}  // namespace lgfx
+#endif
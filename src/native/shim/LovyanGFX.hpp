@@ -0,0 +1,181 @@
+#pragma once
+// Software subset of the LovyanGFX API for host builds. Drawing goes into
+// memory instead of a panel; devices additionally count the address windows
+// and pixels a real panel would have been sent, which is what the replay and
+// render-cost tools measure.
+#include <vector>
+
+#include "Arduino.h"
+
+#define TFT_BLACK 0x0000
+#define TFT_NAVY 0x000F
+#define TFT_DARKGRAY 0x7BEF
+#define TFT_LIGHTGRAY 0xD69A
+#define TFT_ORANGE 0xFDA0
+#define TFT_YELLOW 0xFFE0
+#define TFT_WHITE 0xFFFF
+
+namespace lgfx {
+
+enum color_depth_t : uint8_t {
+    palette_4bit = 4,
+    palette_8bit = 8,
+    rgb565_2Byte = 16,
+};
+
+struct rgb565_t {
+    uint16_t raw;
+};
+
+// What a panel would have received over the bus since the last reset
+struct BusStats {
+    uint32_t windows;  // Address window commands
+    uint64_t pixels;   // Pixels written into those windows
+};
+
+class LovyanGFX : public Print {
+   public:
+    virtual ~LovyanGFX() = default;
+
+    int32_t width() const { return m_width; }
+    int32_t height() const { return m_height; }
+    virtual bool hasPalette() const { return false; }
+
+    void startWrite() { m_writeNesting++; }
+    void endWrite() { if (m_writeNesting > 0) m_writeNesting--; }
+
+    void fillScreen(uint32_t color) { fillRect(0, 0, m_width, m_height, color); }
+    void clear(uint32_t color = 0) { fillScreen(color); }
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) { fillRect(x, y, w, 1, color); }
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) { fillRect(x, y, 1, h, color); }
+    void drawPixel(int32_t x, int32_t y, uint32_t color) { fillRect(x, y, 1, 1, color); }
+    uint32_t readPixelValue(int32_t x, int32_t y) const;
+
+    void setClipRect(int32_t x, int32_t y, int32_t w, int32_t h);
+    void getClipRect(int32_t* x, int32_t* y, int32_t* w, int32_t* h) const;
+    void clearClipRect() { setClipRect(0, 0, m_width, m_height); }
+
+    // Raw pixel streaming, the window is not clipped just like on a panel
+    void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+    void writePixels(const uint16_t* data, int32_t length, bool swap = true);
+    void pushPixels(const uint16_t* data, int32_t length, bool swap = true) { writePixels(data, length, swap); }
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data);
+    void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, const rgb565_t* data) {
+        pushImage(x, y, w, h, reinterpret_cast<const uint16_t*>(data));
+    }
+    void waitDMA() {}
+
+    // Built-in text, glyphs are placeholder bit patterns of the 6x8 cell size
+    void setTextSize(float size) { m_textSize = size < 1 ? 1 : (int)size; }
+    float getTextSizeX() const { return m_textSize; }
+    void setTextColor(uint32_t foreground) { m_textForeground = foreground; m_textBackground = foreground; }
+    void setTextColor(uint32_t foreground, uint32_t background) { m_textForeground = foreground; m_textBackground = background; }
+    void setCursor(int32_t x, int32_t y) { m_cursorX = x; m_cursorY = y; }
+    int32_t getCursorX() const { return m_cursorX; }
+    int32_t getCursorY() const { return m_cursorY; }
+    int32_t textWidth(const char* text) const { return strlen(text) * 6 * m_textSize; }
+    int32_t textWidth(const String& text) const { return textWidth(text.c_str()); }
+    int32_t fontHeight() const { return 8 * m_textSize; }
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    const BusStats& getBusStats() const { return m_stats; }
+    void resetBusStats() { m_stats = {0, 0}; }
+
+   protected:
+    int32_t m_width = 0;
+    int32_t m_height = 0;
+    bool m_countBus = false;  // Only devices have a bus
+
+    void resize(int32_t width, int32_t height);
+    virtual void storePixel(int32_t x, int32_t y, uint32_t value) = 0;
+    virtual uint32_t loadPixel(int32_t x, int32_t y) const = 0;
+
+   private:
+    int32_t m_clipX = 0, m_clipY = 0, m_clipW = 0, m_clipH = 0;
+    int32_t m_windowX = 0, m_windowY = 0, m_windowW = 0, m_windowH = 0;
+    int32_t m_windowPos = 0;
+    int32_t m_writeNesting = 0;
+    int32_t m_cursorX = 0, m_cursorY = 0;
+    int m_textSize = 1;
+    uint32_t m_textForeground = 0xFFFF;
+    uint32_t m_textBackground = 0xFFFF;
+    BusStats m_stats = {0, 0};
+
+    void countWindow(uint64_t pixels);
+};
+
+// RGB565 framebuffer standing in for a panel; subclasses add size and touch
+class LGFX_Device : public LovyanGFX {
+   public:
+    LGFX_Device(int32_t panelWidth = 240, int32_t panelHeight = 320);
+
+    bool init();
+    void setRotation(uint8_t rotation);
+    uint8_t getRotation() const { return m_rotation; }
+    void setBrightness(uint8_t brightness) { m_brightness = brightness; }
+    uint8_t getBrightness() const { return m_brightness; }
+    void sleep() { m_sleeping = true; }
+    void wakeup() { m_sleeping = false; }
+    bool isEPD() const { return false; }
+
+    // Touch is whatever the host program injected last
+    template <typename T>
+    bool getTouch(T* x, T* y) {
+        if (!m_touching) return false;
+        *x = m_touchX;
+        *y = m_touchY;
+        return true;
+    }
+    void setTouchCalibrate(const uint16_t*) {}
+    void calibrateTouch(uint16_t* data, uint32_t, uint32_t, uint32_t) {
+        for (int i = 0; i < 8; i++) data[i] = i & 1 ? m_panelHeight : m_panelWidth;
+    }
+    void injectTouch(bool touching, int32_t x = 0, int32_t y = 0) {
+        m_touching = touching;
+        m_touchX = x;
+        m_touchY = y;
+    }
+
+    const uint16_t* getFramebuffer() const { return m_pixels.data(); }
+    uint32_t frameHash() const;
+
+   protected:
+    void storePixel(int32_t x, int32_t y, uint32_t value) override { m_pixels[y * m_width + x] = value; }
+    uint32_t loadPixel(int32_t x, int32_t y) const override { return m_pixels[y * m_width + x]; }
+
+   private:
+    int32_t m_panelWidth;
+    int32_t m_panelHeight;
+    std::vector<uint16_t> m_pixels;
+    uint8_t m_rotation = 0;
+    uint8_t m_brightness = 255;
+    bool m_sleeping = false;
+    bool m_touching = false;
+    int32_t m_touchX = 0, m_touchY = 0;
+};
+
+class LGFX_Sprite : public LovyanGFX {
+   public:
+    void setColorDepth(color_depth_t depth) { m_depth = depth; }
+    bool hasPalette() const override { return m_depth != rgb565_2Byte; }
+    void* createSprite(int32_t width, int32_t height);
+    void deleteSprite();
+    void* getBuffer() { return m_buffer.empty() ? nullptr : m_buffer.data(); }
+    void setPaletteColor(size_t index, uint8_t r, uint8_t g, uint8_t b);
+    void pushSprite(LovyanGFX* target, int32_t x, int32_t y);
+
+   protected:
+    void storePixel(int32_t x, int32_t y, uint32_t value) override;
+    uint32_t loadPixel(int32_t x, int32_t y) const override;
+
+   private:
+    color_depth_t m_depth = rgb565_2Byte;
+    std::vector<uint8_t> m_buffer;
+    uint16_t m_palette[256] = {};
+    int32_t m_stride = 0;
+};
+
+}  // namespace lgfx
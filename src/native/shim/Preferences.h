@@ -0,0 +1,50 @@
+#pragma once
+// In-memory Preferences for host builds, nothing survives the process
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+
+class Preferences {
+   public:
+    bool begin(const char* name, bool readOnly = false) {
+        m_namespace = name;
+        return true;
+    }
+    void end() {}
+    bool clear() {
+        store().erase(m_namespace);
+        return true;
+    }
+
+    size_t putBytes(const char* key, const void* value, size_t length) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(value);
+        store()[m_namespace][key].assign(bytes, bytes + length);
+        return length;
+    }
+    size_t getBytes(const char* key, void* buffer, size_t length) {
+        auto& entries = store()[m_namespace];
+        auto it = entries.find(key);
+        if (it == entries.end()) return 0;
+        size_t n = std::min(length, it->second.size());
+        memcpy(buffer, it->second.data(), n);
+        return n;
+    }
+    bool putBool(const char* key, bool value) {
+        uint8_t byte = value ? 1 : 0;
+        return putBytes(key, &byte, 1) == 1;
+    }
+    bool getBool(const char* key, bool defaultValue = false) {
+        uint8_t byte = 0;
+        return getBytes(key, &byte, 1) == 1 ? byte != 0 : defaultValue;
+    }
+
+   private:
+    std::string m_namespace;
+
+    static std::map<std::string, std::map<std::string, std::vector<uint8_t>>>& store() {
+        static std::map<std::string, std::map<std::string, std::vector<uint8_t>>> s_store;
+        return s_store;
+    }
+};
@@ -0,0 +1,275 @@
+// Replays a recorded trace (TraceFormat, see src/trace) through GuiManager on
+// the host and checks the rendering cost against limits:
+//
+//   pio run -e native-replay
+//   .pio/build/native-replay/program trace.umt --max-latency-ms 60 --max-bus-us 8000
+//
+// Time is virtual and advances by GuiManager::getFrameDelay() per frame, so a
+// trace always produces the same frames, pixels and latencies. Host frame
+// time is wall clock and only meaningful relative to earlier runs on the
+// same machine. Exit status is 1 when a limit is exceeded, 2 on bad input.
+#ifndef ARDUINO
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <deque>
+#include <vector>
+
+#include "../ESP32_SPI_9341.h"
+#include "../GUI/GuiManager.hpp"
+#include "../app/MixerUi.hpp"
+#include "../comm/CommLink.hpp"
+#include "../comm/LoopbackTransport.hpp"
+#include "../mixer/MixerModel.hpp"
+#include "../mixer/ModelBindings.hpp"
+#include "../mixer/StateSync.hpp"
+#include "../trace/TraceFormat.hpp"
+
+// SPI cost model of the ILI9341 at 40 MHz: 16 bits per pixel plus the
+// CASET/RASET/RAMWR sequence for every address window
+#define BUS_NS_PER_PIXEL 400
+#define BUS_NS_PER_WINDOW 3000
+
+// A message redraws in the frame that drains it, a touch in the frame after
+// the one that reads it; inputs without pixels by then changed nothing visible
+#define LATENCY_MAX_FRAMES 2
+
+#define DEFAULT_TAIL_MS 1000
+
+using Clock = std::chrono::steady_clock;
+
+struct Limit {
+    const char* option;
+    const char* name;
+    double value;  // Negative: not checked
+};
+
+struct PendingInput {
+    uint32_t timeMs;
+    uint32_t framesLeft;
+};
+
+struct Metrics {
+    uint32_t frames = 0;
+    uint32_t drawnFrames = 0;
+    uint64_t hostUsTotal = 0;
+    uint32_t hostUsMax = 0;
+    uint64_t pixelsTotal = 0;
+    uint64_t pixelsMax = 0;
+    uint64_t windowsTotal = 0;
+    uint64_t busUsTotal = 0;
+    uint32_t busUsMax = 0;
+    uint32_t inputs = 0;
+    uint32_t answered = 0;
+    uint64_t latencyMsTotal = 0;
+    uint32_t latencyMsMax = 0;
+};
+
+static bool readFile(const char* path, std::vector<uint8_t>& data) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    fclose(file);
+    return true;
+}
+
+static void usage() {
+    fprintf(stderr,
+            "usage: trace_replay <trace.umt> [--max-frame-us N] [--max-bus-us N]\n"
+            "                    [--max-pixels N] [--max-latency-ms N] [--tail-ms N]\n");
+}
+
+int main(int argc, char** argv) {
+    Limit limits[] = {
+        {"--max-frame-us", "host frame us (max)", -1},
+        {"--max-bus-us", "bus us per frame (max)", -1},
+        {"--max-pixels", "pixels per frame (max)", -1},
+        {"--max-latency-ms", "input latency ms (max)", -1},
+    };
+    const char* path = nullptr;
+    uint32_t tailMs = DEFAULT_TAIL_MS;
+
+    for (int i = 1; i < argc; i++) {
+        bool matched = false;
+        for (auto& limit : limits) {
+            if (strcmp(argv[i], limit.option) == 0 && i + 1 < argc) {
+                limit.value = atof(argv[++i]);
+                matched = true;
+            }
+        }
+        if (matched) {
+            continue;
+        }
+        if (strcmp(argv[i], "--tail-ms") == 0 && i + 1 < argc) {
+            tailMs = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && path == nullptr) {
+            path = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    std::vector<uint8_t> trace;
+    if (path == nullptr || !readFile(path, trace)) {
+        usage();
+        return 2;
+    }
+    TraceReader reader(trace.data(), trace.size());
+    if (!reader.isValid()) {
+        fprintf(stderr, "%s: not a version %d trace\n", path, TRACE_VERSION);
+        return 2;
+    }
+
+    // The same wiring as the firmware, with the host end of a loopback link standing in for the PC
+    static LGFX lcd;
+    static GuiManager gui(lcd);
+    static LoopbackPair pair;
+    static InboxQueue inbox;
+    static OutboxQueue outbox;
+    static CommLink link(pair.device, inbox, outbox);
+    static MixerModel model;
+    static StateSync sync(model);
+    static PresetBank presets(model, sync);
+    static ModelBindings bindings;
+
+    nativeSetMillis(0);
+    gui.init();
+    gui.setMessageQueues(&inbox, &outbox);
+    gui.onMessage = [](const MixerMessage& message) {
+        sync.handle(message, millis());
+    };
+    sync.send = [](const MixerMessage& message) {
+        return gui.postEvent(message);
+    };
+    sync.onChange = [](uint8_t session, uint8_t fields) {
+        bindings.notify(session, fields);
+    };
+    sync.begin(millis());
+    buildMixerUi(gui);
+    buildPresetBar(gui, presets);
+
+    // Trace time starts where recording started, after setup
+    nativeSetMillis(0);
+    lcd.resetBusStats();
+
+    Metrics metrics;
+    std::deque<PendingInput> pending;  // Inputs still waiting for pixels
+    TraceEvent event;
+    bool haveEvent = reader.next(event);
+    uint32_t endMs = 0;
+    uint8_t discard[LOOPBACK_MTU];
+
+    while (haveEvent || millis() <= endMs) {
+        uint32_t now = millis();
+
+        // Everything that happened up to this frame
+        while (haveEvent && event.timeMs <= now) {
+            switch (event.kind) {
+                case TraceKind::TouchDown:
+                    pending.push_back({event.timeMs, LATENCY_MAX_FRAMES});
+                    metrics.inputs++;
+                    lcd.injectTouch(true, event.x, event.y);
+                    break;
+                case TraceKind::TouchMove:
+                    lcd.injectTouch(true, event.x, event.y);
+                    break;
+                case TraceKind::TouchUp:
+                    lcd.injectTouch(false);
+                    break;
+                case TraceKind::Message:
+                    pending.push_back({event.timeMs, LATENCY_MAX_FRAMES});
+                    metrics.inputs++;
+                    pair.host.send(reinterpret_cast<const uint8_t*>(&event.message), sizeof(MixerMessage));
+                    break;
+            }
+            endMs = event.timeMs + tailMs;
+            haveEvent = reader.next(event);
+        }
+        link.poll();
+
+        lgfx::BusStats before = lcd.getBusStats();
+        Clock::time_point start = Clock::now();
+        gui.update();
+        uint32_t hostUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        sync.update(now);
+        link.poll();
+        while (pair.host.recv(discard, sizeof(discard)) > 0) {
+        }
+
+        const lgfx::BusStats& after = lcd.getBusStats();
+        uint64_t pixels = after.pixels - before.pixels;
+        uint32_t windows = after.windows - before.windows;
+        uint32_t busUs = (pixels * BUS_NS_PER_PIXEL + (uint64_t)windows * BUS_NS_PER_WINDOW) / 1000;
+
+        metrics.frames++;
+        metrics.hostUsTotal += hostUs;
+        metrics.hostUsMax = std::max(metrics.hostUsMax, hostUs);
+        metrics.pixelsTotal += pixels;
+        metrics.pixelsMax = std::max(metrics.pixelsMax, pixels);
+        metrics.windowsTotal += windows;
+        metrics.busUsTotal += busUs;
+        metrics.busUsMax = std::max(metrics.busUsMax, busUs);
+
+        // Latency runs until this frame's pixels are on the panel
+        if (pixels > 0) {
+            metrics.drawnFrames++;
+            uint32_t shownMs = now + (busUs + 999) / 1000;
+            for (const auto& input : pending) {
+                uint32_t latency = shownMs - input.timeMs;
+                metrics.answered++;
+                metrics.latencyMsTotal += latency;
+                metrics.latencyMsMax = std::max(metrics.latencyMsMax, latency);
+            }
+            pending.clear();
+        }
+        for (auto& input : pending) {
+            input.framesLeft--;
+        }
+        while (!pending.empty() && pending.front().framesLeft == 0) {
+            pending.pop_front();
+        }
+
+        nativeAdvanceMillis(gui.getFrameDelay());
+    }
+
+    uint32_t frames = std::max<uint32_t>(1, metrics.frames);
+    uint32_t answered = std::max<uint32_t>(1, metrics.answered);
+    printf("trace            %s (%u ms)\n", path, (unsigned)endMs);
+    printf("frames           %u (%u drawn)\n", metrics.frames, metrics.drawnFrames);
+    printf("host frame us    avg %.1f  max %u\n", (double)metrics.hostUsTotal / frames, metrics.hostUsMax);
+    printf("pixels/frame     avg %.1f  max %llu\n", (double)metrics.pixelsTotal / frames, (unsigned long long)metrics.pixelsMax);
+    printf("windows          %llu\n", (unsigned long long)metrics.windowsTotal);
+    printf("bus us/frame     avg %.1f  max %u\n", (double)metrics.busUsTotal / frames, metrics.busUsMax);
+    printf("input latency ms avg %.1f  max %u  (%u of %u inputs redrew)\n", (double)metrics.latencyMsTotal / answered,
+           metrics.latencyMsMax, metrics.answered, metrics.inputs);
+    printf("sync             %s, version %u, %u gaps, %u dropped\n", sync.isSynced() ? "synced" : "unsynced",
+           sync.getVersion(), sync.getGapCount(), link.getDroppedCount());
+    printf("display lists    %u recorded\n", displayListRecordCount());
+    static const char* const opNames[] = {"fill", "frame", "text", "atlas text", "image"};
+    for (uint8_t op = 0; op < static_cast<uint8_t>(DrawOp::Count); op++) {
+        const DrawOpStats& stats = drawOpStats(static_cast<DrawOp>(op));
+        printf("  %-14s %u replayed, %u culled, %u px\n", opNames[op], stats.replayed, stats.culled, stats.pixels);
+    }
+
+    double measured[] = {(double)metrics.hostUsMax, (double)metrics.busUsMax, (double)metrics.pixelsMax, (double)metrics.latencyMsMax};
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++) {
+        if (limits[i].value >= 0 && measured[i] > limits[i].value) {
+            printf("FAIL %s: %.0f > %.0f\n", limits[i].name, measured[i], limits[i].value);
+            failures++;
+        }
+    }
+    return failures > 0 ? 1 : 0;
+}
+
+#endif
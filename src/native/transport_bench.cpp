@@ -0,0 +1,95 @@
+// Host-side throughput test of the comm stack over LoopbackTransport (pio run -e native -t exec)
+#ifndef ARDUINO
+
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../comm/CommLink.hpp"
+#include "../comm/LoopbackTransport.hpp"
+#include "../mixer/MixerModel.hpp"
+
+#define BENCH_MESSAGES 1000000
+#define BENCH_REPLY_EVERY 100
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+int main() {
+    static LoopbackPair pair;
+    static InboxQueue inbox;
+    static OutboxQueue outbox;
+    static MixerModel model;
+    CommLink link(pair.device, inbox, outbox);
+
+    std::atomic<bool> done(false);
+    uint64_t latencyTotalNs = 0;
+    uint64_t latencyMaxNs = 0;
+    uint32_t applied = 0;
+
+    // Device side: the comm task and the UI drain loop, interleaved on one thread
+    std::thread device([&]() {
+        MixerMessage message;
+        while (applied < BENCH_MESSAGES) {
+            link.poll();
+            while (inbox.pop(message)) {
+                uint64_t sentNs;
+                memcpy(&sentNs, message.text, sizeof(sentNs));
+                uint64_t latency = nowNs() - sentNs;
+                latencyTotalNs += latency;
+                latencyMaxNs = latency > latencyMaxNs ? latency : latencyMaxNs;
+                model.apply(message);
+
+                if (++applied % BENCH_REPLY_EVERY == 0) {
+                    MixerMessage reply = {MessageType::SetVolume, message.session, message.value, 0, {0}};
+                    outbox.push(reply);
+                }
+            }
+            std::this_thread::yield();
+        }
+        link.poll();  // Flush the last replies
+        done = true;
+    });
+
+    // Host side: a stream of volume updates, counting replies
+    uint32_t replies = 0;
+    uint64_t start = nowNs();
+    uint32_t sent = 0;
+    while (!done || replies < BENCH_MESSAGES / BENCH_REPLY_EVERY) {
+        if (sent < BENCH_MESSAGES) {
+            MixerMessage message = {MessageType::SessionVolume, (uint8_t)(sent % MAX_SESSIONS), (int16_t)(sent % 101), sent + 1, {0}};
+            uint64_t sentNs = nowNs();
+            memcpy(message.text, &sentNs, sizeof(sentNs));
+            if (pair.host.send(reinterpret_cast<const uint8_t*>(&message), sizeof(message))) {
+                sent++;
+            }
+        }
+
+        uint8_t frame[LOOPBACK_MTU];
+        while (pair.host.recv(frame, sizeof(frame)) > 0) {
+            replies++;
+        }
+        if (done && sent >= BENCH_MESSAGES && pair.toHost.empty()) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    device.join();
+    double seconds = (nowNs() - start) / 1e9;
+
+    const LinkQuality& quality = pair.device.linkQuality();
+    printf("loopback: %u messages in %.3f s, %.0f msg/s, %.2f MB/s\n", applied, seconds, applied / seconds,
+           applied * sizeof(MixerMessage) / seconds / 1e6);
+    printf("latency: avg %.1f us, max %.1f us\n", latencyTotalNs / 1e3 / applied, latencyMaxNs / 1e3);
+    printf("replies: %u, device frames rx %u tx %u, errors %u, dropped %u\n", replies, quality.framesReceived, quality.framesSent,
+           quality.errors, link.getDroppedCount());
+    return link.getDroppedCount() == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "CpuGovernor.hpp"
+#include "../log/Log.hpp"
+
+CpuGovernor::CpuGovernor()
+    : m_pmAvailable(false),
+      m_busy(true),
+      m_lightSleepAllowed(false),
+      m_lock(nullptr),
+      m_transitions(0),
+      m_stateSinceUs(0),
+      m_busyUs(0),
+      m_idleUs(0) {
+}
+
+void CpuGovernor::begin() {
+    m_pmAvailable = configure(false) && esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "gui", &m_lock) == ESP_OK;
+    if (m_pmAvailable) {
+        esp_pm_lock_acquire(m_lock);  // Start busy, matching m_busy
+    } else {
+        LOG_W("Power management unavailable, scaling CPU frequency directly");
+    }
+    m_stateSinceUs = esp_timer_get_time();
+}
+
+bool CpuGovernor::configure(bool lightSleep) {
+    esp_pm_config_esp32_t config;
+    config.max_freq_mhz = CPU_FREQ_BUSY_MHZ;
+    config.min_freq_mhz = CPU_FREQ_IDLE_MHZ;
+    config.light_sleep_enable = lightSleep;
+    return esp_pm_configure(&config) == ESP_OK;
+}
+
+void CpuGovernor::setBusy(bool busy) {
+    if (busy == m_busy) {
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    uint64_t elapsed = now - m_stateSinceUs;
+    if (m_busy) {
+        m_busyUs += elapsed;
+    } else {
+        m_idleUs += elapsed;
+    }
+    m_stateSinceUs = now;
+    m_busy = busy;
+    m_transitions++;
+
+    if (m_pmAvailable) {
+        if (busy) {
+            esp_pm_lock_acquire(m_lock);
+        } else {
+            esp_pm_lock_release(m_lock);
+        }
+    } else {
+        setCpuFrequencyMhz(busy ? CPU_FREQ_BUSY_MHZ : CPU_FREQ_IDLE_MHZ);
+    }
+}
+
+void CpuGovernor::setLightSleepAllowed(bool allowed) {
+    if (!m_pmAvailable || allowed == m_lightSleepAllowed) {
+        return;
+    }
+    // Builds without tickless idle reject light sleep, stay on plain DFS then
+    if (configure(allowed)) {
+        m_lightSleepAllowed = allowed;
+    }
+}
+
+uint32_t CpuGovernor::getTransitionCount() const {
+    return m_transitions;
+}
+
+uint64_t CpuGovernor::getBusyTimeUs() const {
+    return m_busyUs + (m_busy ? esp_timer_get_time() - m_stateSinceUs : 0);
+}
+
+uint64_t CpuGovernor::getIdleTimeUs() const {
+    return m_idleUs + (m_busy ? 0 : esp_timer_get_time() - m_stateSinceUs);
+}
+
+void CpuGovernor::report(Print& out) const {
+    uint64_t busy = getBusyTimeUs();
+    uint64_t idle = getIdleTimeUs();
+    uint64_t total = busy + idle;
+    out.printf("cpu: %s, %lu transitions, busy %lu ms (%u%%), idle %lu ms, light sleep %s\n",
+               m_pmAvailable ? "pm locks" : "direct", (unsigned long)m_transitions, (unsigned long)(busy / 1000),
+               total > 0 ? (unsigned)(busy * 100 / total) : 0, (unsigned long)(idle / 1000), m_lightSleepAllowed ? "on" : "off");
+}
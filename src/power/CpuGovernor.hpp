@@ -0,0 +1,42 @@
+#pragma once
+#include <esp_pm.h>
+#include <esp_timer.h>
+
+#include "Arduino.h"
+
+#define CPU_FREQ_BUSY_MHZ 240
+#define CPU_FREQ_IDLE_MHZ 80
+
+// Runs the CPU at full speed only while the UI has work (touch, animation,
+// host bursts). Uses ESP-IDF power management locks when the SDK was built with
+// CONFIG_PM_ENABLE, otherwise switches the frequency directly.
+class CpuGovernor {
+   public:
+    CpuGovernor();
+
+    void begin();
+
+    // Called from the UI loop before GuiManager::update()
+    void setBusy(bool busy);
+
+    // Light sleep stops the LEDC backlight and UART clocks, so it is only allowed
+    // while the panel is blank and the transport survives it
+    void setLightSleepAllowed(bool allowed);
+
+    uint32_t getTransitionCount() const;
+    uint64_t getBusyTimeUs() const;
+    uint64_t getIdleTimeUs() const;
+    void report(Print& out) const;
+
+   private:
+    bool m_pmAvailable;
+    bool m_busy;
+    bool m_lightSleepAllowed;
+    esp_pm_lock_handle_t m_lock;
+    uint32_t m_transitions;
+    int64_t m_stateSinceUs;  // esp_timer time, micros() would wrap after 71 minutes
+    uint64_t m_busyUs;
+    uint64_t m_idleUs;
+
+    bool configure(bool lightSleep);
+};
@@ -0,0 +1,134 @@
+#include "PowerManager.hpp"
+
+// Backlight at evenly spaced ambient levels (0, 32, .. 255), perceptually shaped
+static const uint8_t BACKLIGHT_CURVE[9] = {12, 20, 32, 52, 80, 112, 152, 200, 255};
+
+PowerManager* PowerManager::s_instance = nullptr;
+
+PowerManager::PowerManager(LGFX& lcd, GuiManager& gui, int lightPin, int touchIrqPin)
+    : m_lcd(lcd),
+      m_gui(gui),
+      m_lightPin(lightPin),
+      m_touchIrqPin(touchIrqPin),
+      m_task(nullptr),
+      m_state(PowerState::Active),
+      m_filteredLevel(255 << 8),
+      m_wakeMs(0),
+      m_brightness(0) {
+}
+
+void PowerManager::begin(BaseType_t core) {
+    s_instance = this;
+    pinMode(m_lightPin, INPUT);
+    pinMode(m_touchIrqPin, INPUT);
+
+    // Seed the filter so the first frames do not fade in from full brightness
+    sampleLight();
+    m_filteredLevel = (int32_t)getAmbientLevel() << 8;
+    applyBrightness(brightnessForLevel(getAmbientLevel()));
+
+    xTaskCreatePinnedToCore(PowerManager::taskEntry, "power", POWER_TASK_STACK, this, POWER_TASK_PRIORITY, &m_task, core);
+    attachInterrupt(digitalPinToInterrupt(m_touchIrqPin), PowerManager::onTouchIrq, FALLING);
+}
+
+PowerState PowerManager::getState() const {
+    return m_state.load();
+}
+
+uint8_t PowerManager::getAmbientLevel() const {
+    return m_filteredLevel >> 8;
+}
+
+TaskHandle_t PowerManager::getTask() const {
+    return m_task;
+}
+
+void IRAM_ATTR PowerManager::onTouchIrq() {
+    // Only a sleeping panel needs the task woken early, otherwise GuiManager sees the touch
+    if (s_instance != nullptr && s_instance->m_task != nullptr && s_instance->m_state.load() == PowerState::Asleep) {
+        BaseType_t woken = 0;
+        vTaskNotifyGiveFromISR(s_instance->m_task, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+void PowerManager::taskEntry(void* arg) {
+    static_cast<PowerManager*>(arg)->run();
+}
+
+void PowerManager::run() {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POWER_SAMPLE_MS));
+        uint32_t now = millis();
+
+        if (m_state.load() == PowerState::Asleep) {
+            if (digitalRead(m_touchIrqPin) == LOW) {
+                m_wakeMs = now;
+                setState(PowerState::Active);
+            }
+            continue;  // No point following the room while the backlight is off
+        }
+
+        sampleLight();
+
+        uint32_t lastActivity = std::max(m_gui.getLastActivityMs(), m_wakeMs);
+        uint32_t idle = now - lastActivity;
+        if (idle >= POWER_SLEEP_AFTER_MS) {
+            setState(PowerState::Asleep);
+        } else if (idle >= POWER_DIM_AFTER_MS) {
+            setState(PowerState::Dimmed);
+        } else {
+            setState(PowerState::Active);
+        }
+    }
+}
+
+void PowerManager::sampleLight() {
+    int raw = analogRead(m_lightPin);
+    int32_t level = (int32_t)(raw - LIGHT_ADC_DARK) * 255 / (LIGHT_ADC_BRIGHT - LIGHT_ADC_DARK);
+    level = std::max<int32_t>(0, std::min<int32_t>(255, level));
+
+    // Exponential moving average (1/8) smooths flicker and passing shadows
+    m_filteredLevel += ((level << 8) - m_filteredLevel) / 8;
+}
+
+uint8_t PowerManager::brightnessForLevel(uint8_t level) const {
+    int index = level >> 5;
+    if (index >= 8) {
+        return BACKLIGHT_CURVE[8];
+    }
+    int low = BACKLIGHT_CURVE[index];
+    int high = BACKLIGHT_CURVE[index + 1];
+    return low + ((high - low) * (level & 31)) / 32;
+}
+
+void PowerManager::applyBrightness(uint8_t brightness) {
+    // Small changes are not worth a PWM update and would shimmer
+    if (abs((int)brightness - (int)m_brightness) < 3 && brightness != 0 && m_brightness != 0) {
+        return;
+    }
+    m_brightness = brightness;
+    m_lcd.setBrightness(brightness);
+}
+
+void PowerManager::setState(PowerState state) {
+    PowerState previous = m_state.exchange(state);
+
+    if (state == PowerState::Asleep) {
+        if (previous != PowerState::Asleep) {
+            applyBrightness(0);
+            m_gui.setSuspended(true);  // The UI task blanks the panel on its next update
+        }
+        return;
+    }
+
+    if (previous == PowerState::Asleep) {
+        m_gui.setSuspended(false);
+    }
+
+    uint8_t brightness = brightnessForLevel(getAmbientLevel());
+    if (state == PowerState::Dimmed) {
+        brightness = std::min<uint8_t>(brightness, POWER_DIM_BRIGHTNESS);
+    }
+    applyBrightness(brightness);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+
+#include "Arduino.h"
+#include "../GUI/GuiManager.hpp"
+
+#define POWER_SAMPLE_MS 200
+#define POWER_DIM_AFTER_MS 30000UL
+#define POWER_SLEEP_AFTER_MS 300000UL
+#define POWER_DIM_BRIGHTNESS 16
+#define POWER_TASK_STACK 2048
+#define POWER_TASK_PRIORITY 1
+
+// Raw ADC readings of the light sensor at the ends of the backlight curve.
+// The LDR divider reads lower the brighter the room is.
+#define LIGHT_ADC_DARK 1200
+#define LIGHT_ADC_BRIGHT 0
+
+enum class PowerState : uint8_t {
+    Active,
+    Dimmed,
+    Asleep
+};
+
+// Background task that follows ambient light with the backlight, dims after
+// inactivity and blanks the panel (suspending GuiManager rendering) after a
+// longer idle. A touch IRQ while asleep wakes everything; that first touch is
+// swallowed so it does not press whatever is under the finger.
+class PowerManager {
+   public:
+    PowerManager(LGFX& lcd, GuiManager& gui, int lightPin, int touchIrqPin);
+
+    void begin(BaseType_t core = 0);
+
+    PowerState getState() const;
+    uint8_t getAmbientLevel() const;  // Filtered, 0 = dark .. 255 = bright
+    TaskHandle_t getTask() const;
+
+   private:
+    LGFX& m_lcd;
+    GuiManager& m_gui;
+    int m_lightPin;
+    int m_touchIrqPin;
+    TaskHandle_t m_task;
+    std::atomic<PowerState> m_state;
+    int32_t m_filteredLevel;  // Q8 fixed point
+    uint32_t m_wakeMs;
+    uint8_t m_brightness;
+
+    static PowerManager* s_instance;
+    static void IRAM_ATTR onTouchIrq();
+    static void taskEntry(void* arg);
+    void run();
+
+    void sampleLight();
+    uint8_t brightnessForLevel(uint8_t level) const;
+    void applyBrightness(uint8_t brightness);
+    void setState(PowerState state);
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define FLASH_SECTOR_SIZE 4096
+
+// A span of NOR flash: erase sets whole sectors to 0xFF, writes can only clear
+// bits. Offsets are relative to the start of the region.
+class FlashRegion {
+   public:
+    virtual ~FlashRegion() = default;
+
+    virtual bool begin() = 0;
+    virtual size_t size() const = 0;
+
+    virtual bool read(size_t offset, void* data, size_t length) = 0;
+    virtual bool write(size_t offset, const void* data, size_t length) = 0;
+    virtual bool eraseSector(size_t sector) = 0;
+};
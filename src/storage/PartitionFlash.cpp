@@ -0,0 +1,28 @@
+#ifdef ARDUINO
+#include "PartitionFlash.hpp"
+
+PartitionFlash::PartitionFlash(const char* label) : m_label(label), m_partition(nullptr) {
+}
+
+bool PartitionFlash::begin() {
+    m_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, m_label);
+    return m_partition != nullptr;
+}
+
+size_t PartitionFlash::size() const {
+    return m_partition != nullptr ? m_partition->size : 0;
+}
+
+bool PartitionFlash::read(size_t offset, void* data, size_t length) {
+    return m_partition != nullptr && esp_partition_read(m_partition, offset, data, length) == ESP_OK;
+}
+
+bool PartitionFlash::write(size_t offset, const void* data, size_t length) {
+    return m_partition != nullptr && esp_partition_write(m_partition, offset, data, length) == ESP_OK;
+}
+
+bool PartitionFlash::eraseSector(size_t sector) {
+    return m_partition != nullptr && esp_partition_erase_range(m_partition, sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE) == ESP_OK;
+}
+
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+#ifdef ARDUINO
+#include <esp_partition.h>
+
+#include "FlashRegion.hpp"
+
+// A data partition from partitions.csv, found by its label
+class PartitionFlash : public FlashRegion {
+   public:
+    PartitionFlash(const char* label);
+
+    bool begin() override;
+    size_t size() const override;
+    bool read(size_t offset, void* data, size_t length) override;
+    bool write(size_t offset, const void* data, size_t length) override;
+    bool eraseSector(size_t sector) override;
+
+   private:
+    const char* m_label;
+    const esp_partition_t* m_partition;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "RamFlash.hpp"
+
+#include <string.h>
+
+RamFlash::RamFlash(size_t sectors) : m_bytes(sectors * FLASH_SECTOR_SIZE, 0xFF), m_erases(sectors, 0) {
+}
+
+bool RamFlash::begin() {
+    return true;
+}
+
+size_t RamFlash::size() const {
+    return m_bytes.size();
+}
+
+bool RamFlash::read(size_t offset, void* data, size_t length) {
+    if (offset + length > m_bytes.size()) {
+        return false;
+    }
+    memcpy(data, &m_bytes[offset], length);
+    return true;
+}
+
+bool RamFlash::write(size_t offset, const void* data, size_t length) {
+    if (offset + length > m_bytes.size()) {
+        return false;
+    }
+    // Programming only clears bits, like the real part
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; i++) {
+        m_bytes[offset + i] &= bytes[i];
+    }
+    return true;
+}
+
+bool RamFlash::eraseSector(size_t sector) {
+    if (sector >= m_erases.size()) {
+        return false;
+    }
+    memset(&m_bytes[sector * FLASH_SECTOR_SIZE], 0xFF, FLASH_SECTOR_SIZE);
+    m_erases[sector]++;
+    return true;
+}
+
+uint32_t RamFlash::getEraseCount(size_t sector) const {
+    return sector < m_erases.size() ? m_erases[sector] : 0;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <vector>
+
+#include "FlashRegion.hpp"
+
+// Flash simulated in RAM with NOR semantics, portable C++ so storage code runs
+// on the host (env:native). Counts erases per sector to check wear leveling.
+class RamFlash : public FlashRegion {
+   public:
+    RamFlash(size_t sectors);
+
+    bool begin() override;
+    size_t size() const override;
+    bool read(size_t offset, void* data, size_t length) override;
+    bool write(size_t offset, const void* data, size_t length) override;
+    bool eraseSector(size_t sector) override;
+
+    uint32_t getEraseCount(size_t sector) const;
+
+   private:
+    std::vector<uint8_t> m_bytes;
+    std::vector<uint32_t> m_erases;
+};
@@ -0,0 +1,111 @@
+#include "TraceFormat.hpp"
+
+#include <string.h>
+
+size_t writeTraceHeader(uint8_t* out, size_t capacity) {
+    if (capacity < TRACE_HEADER_BYTES) {
+        return 0;
+    }
+    memcpy(out, TRACE_MAGIC, 4);
+    out[4] = TRACE_VERSION;
+    return TRACE_HEADER_BYTES;
+}
+
+size_t encodeTraceEvent(const TraceEvent& event, uint32_t previousMs, uint8_t* out, size_t capacity) {
+    uint8_t record[TRACE_MAX_RECORD_BYTES];
+    size_t length = 0;
+
+    uint32_t delta = event.timeMs - previousMs;
+    do {
+        uint8_t byte = delta & 0x7F;
+        delta >>= 7;
+        record[length++] = byte | (delta != 0 ? 0x80 : 0);
+    } while (delta != 0);
+
+    record[length++] = static_cast<uint8_t>(event.kind);
+    switch (event.kind) {
+        case TraceKind::TouchDown:
+        case TraceKind::TouchMove:
+            record[length++] = event.x & 0xFF;
+            record[length++] = (event.x >> 8) & 0xFF;
+            record[length++] = event.y & 0xFF;
+            record[length++] = (event.y >> 8) & 0xFF;
+            break;
+        case TraceKind::Message:
+            record[length++] = sizeof(MixerMessage);
+            memcpy(record + length, &event.message, sizeof(MixerMessage));
+            length += sizeof(MixerMessage);
+            break;
+        case TraceKind::TouchUp:
+            break;
+    }
+
+    if (length > capacity) {
+        return 0;
+    }
+    memcpy(out, record, length);
+    return length;
+}
+
+TraceReader::TraceReader(const uint8_t* data, size_t length)
+    : m_data(data), m_length(length), m_position(TRACE_HEADER_BYTES), m_timeMs(0), m_valid(false) {
+    m_valid = length >= TRACE_HEADER_BYTES && memcmp(data, TRACE_MAGIC, 4) == 0 && data[4] == TRACE_VERSION;
+}
+
+bool TraceReader::isValid() const {
+    return m_valid;
+}
+
+bool TraceReader::next(TraceEvent& event) {
+    if (!m_valid) {
+        return false;
+    }
+
+    uint32_t delta = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        if (m_position >= m_length || shift > 28) {
+            return false;
+        }
+        byte = m_data[m_position++];
+        delta |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    if (m_position >= m_length) {
+        return false;
+    }
+    memset(&event, 0, sizeof(event));
+    m_timeMs += delta;
+    event.timeMs = m_timeMs;
+    event.kind = static_cast<TraceKind>(m_data[m_position++]);
+
+    switch (event.kind) {
+        case TraceKind::TouchDown:
+        case TraceKind::TouchMove:
+            if (m_length - m_position < 4) {
+                return false;
+            }
+            event.x = (int16_t)(m_data[m_position] | (m_data[m_position + 1] << 8));
+            event.y = (int16_t)(m_data[m_position + 2] | (m_data[m_position + 3] << 8));
+            m_position += 4;
+            return true;
+        case TraceKind::TouchUp:
+            return true;
+        case TraceKind::Message: {
+            if (m_position >= m_length) {
+                return false;
+            }
+            size_t length = m_data[m_position++];
+            if (length != sizeof(MixerMessage) || m_length - m_position < length) {
+                return false;  // Recorded by a build with a different message layout
+            }
+            memcpy(&event.message, m_data + m_position, length);
+            m_position += length;
+            return true;
+        }
+    }
+    m_valid = false;  // Unknown record kind, nothing after it can be trusted
+    return false;
+}
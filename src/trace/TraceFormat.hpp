@@ -0,0 +1,55 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../comm/messages.hpp"
+
+#define TRACE_MAGIC "UMTR"
+#define TRACE_VERSION 1
+#define TRACE_HEADER_BYTES 5
+#define TRACE_MAX_RECORD_BYTES (5 + 1 + 1 + sizeof(MixerMessage))
+
+// Input trace of one session at the device: everything that reaches the UI
+// loop from outside, so a replay through the same code is deterministic.
+//
+// File: "UMTR", version byte, then records back to back:
+//   varint  ms since the previous record (since recording start for the first)
+//   uint8   TraceKind
+//   payload TouchDown/TouchMove: int16 x, int16 y; TouchUp: nothing;
+//           Message: uint8 length + the frame as received (a raw MixerMessage)
+enum class TraceKind : uint8_t {
+    TouchDown = 1,
+    TouchMove = 2,
+    TouchUp = 3,
+    Message = 4
+};
+
+struct TraceEvent {
+    uint32_t timeMs;
+    TraceKind kind;
+    int16_t x;
+    int16_t y;
+    MixerMessage message;
+};
+
+// Header into out, returns bytes written (0 if it does not fit)
+size_t writeTraceHeader(uint8_t* out, size_t capacity);
+
+// One record into out, returns bytes written (0 if it does not fit)
+size_t encodeTraceEvent(const TraceEvent& event, uint32_t previousMs, uint8_t* out, size_t capacity);
+
+// Walks a complete trace held in memory
+class TraceReader {
+   public:
+    TraceReader(const uint8_t* data, size_t length);
+
+    bool isValid() const;
+    bool next(TraceEvent& event);
+
+   private:
+    const uint8_t* m_data;
+    size_t m_length;
+    size_t m_position;
+    uint32_t m_timeMs;
+    bool m_valid;
+};
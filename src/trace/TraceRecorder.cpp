@@ -0,0 +1,109 @@
+#include "TraceRecorder.hpp"
+
+#include <string.h>
+
+TraceRecorder::TraceRecorder()
+    : m_size(0),
+      m_startMs(0),
+      m_lastMs(0),
+      m_flushedMs(0),
+      m_flushedBytes(0),
+      m_recording(false),
+      m_full(false),
+      m_touching(false),
+      m_touchX(0),
+      m_touchY(0) {
+}
+
+void TraceRecorder::start(uint32_t nowMs) {
+    m_size = writeTraceHeader(m_buffer, sizeof(m_buffer));
+    m_startMs = nowMs;
+    m_lastMs = 0;
+    m_flushedMs = nowMs;
+    m_flushedBytes = 0;
+    m_full = false;
+    m_touching = false;
+    m_recording = true;
+}
+
+void TraceRecorder::stop() {
+    m_recording = false;
+}
+
+bool TraceRecorder::isRecording() const {
+    return m_recording;
+}
+
+bool TraceRecorder::isFull() const {
+    return m_full;
+}
+
+bool TraceRecorder::needsFlush(uint32_t nowMs) const {
+    return m_size > 0 && (m_full || m_size >= TRACE_FLUSH_BYTES || nowMs - m_flushedMs >= TRACE_FLUSH_MS);
+}
+
+void TraceRecorder::flushed(uint32_t nowMs) {
+    // m_lastMs stays, the next record's delta continues from the last stored one
+    m_flushedBytes += m_size;
+    m_size = 0;
+    m_flushedMs = nowMs;
+}
+
+bool TraceRecorder::isFirstFlush() const {
+    return m_flushedBytes == 0;
+}
+
+uint32_t TraceRecorder::getFlushedBytes() const {
+    return m_flushedBytes;
+}
+
+void TraceRecorder::recordTouch(bool touching, int x, int y, uint32_t nowMs) {
+    if (!m_recording) {
+        return;
+    }
+    if (touching == m_touching && (!touching || (x == m_touchX && y == m_touchY))) {
+        return;
+    }
+
+    TraceEvent event;
+    memset(&event, 0, sizeof(event));
+    event.kind = !touching ? TraceKind::TouchUp : (m_touching ? TraceKind::TouchMove : TraceKind::TouchDown);
+    event.x = x;
+    event.y = y;
+    m_touching = touching;
+    m_touchX = x;
+    m_touchY = y;
+    append(event, nowMs);
+}
+
+void TraceRecorder::recordMessage(const MixerMessage& message, uint32_t nowMs) {
+    if (!m_recording) {
+        return;
+    }
+
+    TraceEvent event;
+    memset(&event, 0, sizeof(event));
+    event.kind = TraceKind::Message;
+    event.message = message;
+    append(event, nowMs);
+}
+
+const uint8_t* TraceRecorder::data() const {
+    return m_buffer;
+}
+
+size_t TraceRecorder::size() const {
+    return m_size;
+}
+
+void TraceRecorder::append(TraceEvent& event, uint32_t nowMs) {
+    event.timeMs = nowMs - m_startMs;
+    size_t written = encodeTraceEvent(event, m_lastMs, m_buffer + m_size, sizeof(m_buffer) - m_size);
+    if (written == 0) {
+        m_full = true;
+        m_recording = false;
+        return;
+    }
+    m_size += written;
+    m_lastMs = event.timeMs;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "TraceFormat.hpp"
+
+#define TRACE_BUFFER_BYTES 16384
+#define TRACE_FLUSH_MS 5000                         // Recorded input reaches the card at least this often,
+#define TRACE_FLUSH_BYTES (TRACE_BUFFER_BYTES / 2)  // or sooner once this much is waiting
+
+// Records what the UI loop receives into a fixed RAM buffer in TraceFormat.
+// Called from the UI task only. The owner appends the buffer to a file when
+// needsFlush() says so and calls flushed(); the buffer then starts over while
+// the record times carry on, so the file stays one continuous trace. Recording
+// stops by itself if the buffer fills between flushes rather than wrapping, a
+// replay needs the session without gaps.
+class TraceRecorder {
+   public:
+    TraceRecorder();
+
+    void start(uint32_t nowMs);
+    void stop();
+    bool isRecording() const;
+    bool isFull() const;
+
+    // Recorded bytes are waiting and it is time to store them
+    bool needsFlush(uint32_t nowMs) const;
+    // The caller has stored data() and size(), the buffer starts over
+    void flushed(uint32_t nowMs);
+    // Nothing stored since start(), the file has to be started anew
+    bool isFirstFlush() const;
+    uint32_t getFlushedBytes() const;  // Since start()
+
+    // Touch state as read once per frame, only changes are stored
+    void recordTouch(bool touching, int x, int y, uint32_t nowMs);
+    void recordMessage(const MixerMessage& message, uint32_t nowMs);
+
+    const uint8_t* data() const;
+    size_t size() const;
+
+   private:
+    uint8_t m_buffer[TRACE_BUFFER_BYTES];
+    size_t m_size;
+    uint32_t m_startMs;
+    uint32_t m_lastMs;
+    uint32_t m_flushedMs;
+    uint32_t m_flushedBytes;
+    bool m_recording;
+    bool m_full;
+    bool m_touching;
+    int m_touchX;
+    int m_touchY;
+
+    void append(TraceEvent& event, uint32_t nowMs);
+};
@@ -1,10 +1,12 @@
-
+#pragma once
+#include <algorithm>
+#include "Arduino.h"
+#include "log/Log.hpp"
 
 struct Point {
     int x;
     int y;
 };
-using f_void = void (*)();
 
 class Rectangle {
    public:
@@ -23,15 +25,31 @@ class Rectangle {
     Point getMiddle() {
         return {origin.x + (w / 2), origin.y + (h / 2)};
     }
-    bool checkInside(Point p) {
-        Serial.printf("point: %d %d\n", p.x, p.y);
-        Serial.printf("origin: %d %d\n", origin.x, origin.y);
-        Serial.printf("top right: %d %d\n", topRight.x, topRight.y);
-        bool arr[] = {p.x >= origin.x, p.x <= topRight.x, p.y >= origin.y, p.y <= topRight.y};
-        for (size_t i = 0; i < 4; i++) {
-            Serial.printf("%d ", arr[i]);
-        }
-        Serial.println("");
-        return (p.x >= origin.x && p.x <= topRight.x && p.y >= origin.y && p.y <= topRight.y);
+    bool contains(Point p) const {
+        return p.x >= origin.x && p.x < origin.x + w && p.y >= origin.y && p.y < origin.y + h;
+    }
+    bool contains(const Rectangle& other) const {
+        return other.origin.x >= origin.x && other.origin.y >= origin.y && other.origin.x + other.w <= origin.x + w &&
+               other.origin.y + other.h <= origin.y + h;
+    }
+    bool intersects(const Rectangle& other) const {
+        return other.origin.x < origin.x + w && origin.x < other.origin.x + other.w && other.origin.y < origin.y + h &&
+               origin.y < other.origin.y + other.h;
+    }
+    Rectangle intersection(const Rectangle& other) const {
+        int x0 = std::max(origin.x, other.origin.x);
+        int y0 = std::max(origin.y, other.origin.y);
+        int x1 = std::min(origin.x + w, other.origin.x + other.w);
+        int y1 = std::min(origin.y + h, other.origin.y + other.h);
+        return Rectangle(x0, y0, std::max(0, x1 - x0), std::max(0, y1 - y0));
+    }
+    Rectangle translated(int dx, int dy) const {
+        return Rectangle(origin.x + dx, origin.y + dy, w, h);
+    }
+    // Same half-open bounds as contains(), so hit testing and drawing agree on the edge pixel
+    bool checkInside(Point p) const {
+        bool inside = contains(p);
+        LOG_V("hit %d,%d in %d,%d %dx%d: %d", p.x, p.y, origin.x, origin.y, w, h, inside);
+        return inside;
     }
 };
@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+
+// Golden results of the render-cost scenes in test_main.cpp: final frame hash
+// (FNV-1a of the RGB565 framebuffer), address windows and bytes sent over SPI
+struct RenderBaseline {
+    const char* scene;
+    uint32_t frameHash;
+    uint32_t windows;
+    uint64_t bytes;
+};
+
+static const RenderBaseline RENDER_BASELINES[] = {
+    {"idle_mixer", 0x0388DC55, 70, 127772},
+    {"fader_drag", 0x539538C5, 630, 719552},
+    {"meter_storm", 0x5B71BBC5, 247, 3378960},
+    {"page_switch", 0xB07D8CD5, 8, 1228800},
+    {"list_scroll", 0x09E2A385, 15672, 4941990},
+    {"mixer_strips", 0xEEBBAF65, 174, 765372},
+    {"scroll_view", 0xF03BA775, 9714, 5670880},
+};
@@ -0,0 +1,252 @@
+// Render-cost regression suite (pio test -e native-test). Canonical scenes run
+// on the framebuffer device from src/native/shim; each must reproduce its
+// committed frame hash and must not push more bus traffic than its baseline.
+// A failure prints the measured line in baselines.hpp format, paste it there
+// only when the change in pixels or traffic is intended.
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "../../src/GUI/GuiManager.hpp"
+#include "../../src/GUI/container.hpp"
+#include "../../src/mixer/MixerModel.hpp"
+#include "../../src/mixer/ModelBindings.hpp"
+#include "../../src/mixer/StateSync.hpp"
+#include "baselines.hpp"
+
+struct SceneRig {
+    LGFX lcd;
+    GuiManager gui{lcd};
+    InboxQueue inbox;
+    OutboxQueue outbox;
+    MixerModel model;
+    StateSync sync{model};
+    ModelBindings bindings;
+
+    SceneRig() {
+        nativeSetMillis(0);
+        gui.init();
+        gui.setMessageQueues(&inbox, &outbox);
+        gui.onMessage = MessageHandler::bind<SceneRig, &SceneRig::handleMessage>(this);
+        sync.onChange = ChangeHandler::bind<SceneRig, &SceneRig::notify>(this);
+        lcd.resetBusStats();
+    }
+
+    void handleMessage(const MixerMessage& message) {
+        sync.handle(message, millis());
+    }
+
+    void notify(uint8_t session, uint8_t fields) {
+        bindings.notify(session, fields);
+    }
+
+    void frames(int count) {
+        for (int i = 0; i < count; i++) {
+            gui.update();
+            nativeAdvanceMillis(gui.getFrameDelay());
+        }
+    }
+
+    void host(MessageType type, uint8_t session, int16_t value, uint32_t sequence) {
+        MixerMessage message = {type, session, value, sequence, {0}};
+        inbox.push(message);
+    }
+};
+
+static void checkBaseline(const char* scene, SceneRig& rig) {
+    const lgfx::BusStats& stats = rig.lcd.getBusStats();
+    uint32_t hash = rig.lcd.frameHash();
+    uint64_t bytes = stats.pixels * 2;
+
+    const RenderBaseline* baseline = nullptr;
+    for (const auto& entry : RENDER_BASELINES) {
+        if (strcmp(entry.scene, scene) == 0) {
+            baseline = &entry;
+        }
+    }
+
+    char measured[128];
+    snprintf(measured, sizeof(measured), "{\"%s\", 0x%08X, %u, %llu},", scene, hash, stats.windows, (unsigned long long)bytes);
+    if (baseline == nullptr || baseline->frameHash != hash || stats.windows > baseline->windows || bytes > baseline->bytes) {
+        printf("measured: %s\n", measured);
+    }
+
+    TEST_ASSERT_NOT_NULL_MESSAGE(baseline, "scene has no baseline");
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(baseline->frameHash, hash, "final frame differs from the golden image");
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(baseline->windows, stats.windows, "more address windows than the baseline");
+    TEST_ASSERT_TRUE_MESSAGE(bytes <= baseline->bytes, "more bytes pushed than the baseline");
+    if (stats.windows < baseline->windows || bytes < baseline->bytes) {
+        printf("%s is cheaper than its baseline, tighten it: %s\n", scene, measured);
+    }
+}
+
+// A mixer at rest: one full draw, then nothing may reach the bus
+void test_idle_mixer() {
+    SceneRig rig;
+    for (int i = 0; i < 4; i++) {
+        rig.gui.createButton(10 + i * 76, 10, 70, 220, String(i));
+    }
+    rig.frames(50);
+    checkBaseline("idle_mixer", rig);
+}
+
+// A knob dragged down a fader track, both repaint on every move
+void test_fader_drag() {
+    SceneRig rig;
+    Button* track = rig.gui.createButton(140, 10, 40, 220, "");
+    Button* knob = rig.gui.createButton(130, 10, 60, 30, "=");
+    track->onDrag = [knob](Component& component, Point pos) {
+        knob->bounds = Rectangle(130, std::min(200, std::max(10, pos.y - 15)), 60, 30);
+        component.markDirty();
+        knob->markDirty();
+    };
+    rig.frames(2);
+    uint32_t recorded = displayListRecordCount();
+
+    // The press lands on the track below the knob, which is on top and would take it
+    for (int y = 47; y <= 200; y += 9) {
+        rig.lcd.injectTouch(true, 160, y);
+        rig.frames(1);
+    }
+    rig.lcd.injectTouch(false);
+    rig.frames(20);  // The pressed highlight fades out
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(recorded, displayListRecordCount(), "moving or pressing recorded a display list again");
+    checkBaseline("fader_drag", rig);
+}
+
+// Volume deltas for every session on every frame, meters bound through the model
+void test_meter_storm() {
+    SceneRig rig;
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+        Button* meter = rig.gui.createButton(4 + i * 39, 40, 36, 190, "");
+        rig.bindings.bind(meter, i, FIELD_VOLUME);
+    }
+
+    rig.host(MessageType::SnapshotBegin, 0, 0, 1);
+    for (int i = 0; i < MAX_SESSIONS; i++) {
+        rig.host(MessageType::SessionAdded, i, 0, 1);
+    }
+    rig.host(MessageType::SnapshotEnd, 0, 0, 1);
+    rig.frames(2);
+
+    uint32_t sequence = 1;
+    for (int frame = 0; frame < 30; frame++) {
+        for (int i = 0; i < MAX_SESSIONS; i++) {
+            rig.host(MessageType::SessionVolume, i, (frame * 7 + i * 13) % 100, ++sequence);
+        }
+        rig.frames(1);
+    }
+    checkBaseline("meter_storm", rig);
+}
+
+// Back and forth between two pages, returning ones come from their snapshot
+void test_page_switch() {
+    SceneRig rig;
+    Page* mixer = rig.gui.getCurrentPage();
+    for (int i = 0; i < 6; i++) {
+        rig.gui.createButton(10 + (i % 3) * 100, 10 + (i / 3) * 115, 95, 105, String(i));
+    }
+    Page* settings = rig.gui.createPage("settings");
+    rig.gui.showPage(settings);
+    for (int i = 0; i < 4; i++) {
+        rig.gui.createButton(10, 10 + i * 55, 300, 50, String("option ") + String(i));
+    }
+    rig.gui.showPage(mixer);
+    rig.frames(2);
+
+    for (int i = 0; i < 6; i++) {
+        rig.gui.showPage(i % 2 == 0 ? settings : mixer);
+        rig.frames(3);
+    }
+    checkBaseline("page_switch", rig);
+}
+
+// Rows moved up a few pixels per frame and repainted in place
+void test_list_scroll() {
+    SceneRig rig;
+    Button* rows[10];
+    for (int i = 0; i < 10; i++) {
+        rows[i] = rig.gui.createButton(10, 10 + i * 45, 300, 40, String("row ") + String(i));
+    }
+    rig.frames(2);
+
+    for (int offset = 4; offset <= 120; offset += 4) {
+        for (int i = 0; i < 10; i++) {
+            rows[i]->bounds = Rectangle(10, 10 + i * 45 - offset, 300, 40);
+            rows[i]->markDirty();
+        }
+        rig.frames(1);
+    }
+    checkBaseline("list_scroll", rig);
+}
+
+// Nested strips (panel with label and fader) in a row, one session's volume moving
+void test_mixer_strips() {
+    SceneRig rig;
+    Row* strips = new Row(Rectangle(0, 0, 320, 240), 4);
+    rig.gui.addComponent(strips);
+    for (int i = 0; i < 4; i++) {
+        Panel* strip = new Panel(Rectangle(0, 0, 77, 240));
+        Button* label = new Button(Rectangle(4, 4, 69, 30), String(i));
+        Button* fader = new Button(Rectangle(24, 40, 29, 190), "");
+        strip->addChild(label);
+        strip->addChild(fader);
+        strips->addChild(strip);
+        rig.bindings.bind(fader, i, FIELD_VOLUME);
+    }
+
+    rig.host(MessageType::SnapshotBegin, 0, 0, 1);
+    for (int i = 0; i < 4; i++) {
+        rig.host(MessageType::SessionAdded, i, 0, 1);
+    }
+    rig.host(MessageType::SnapshotEnd, 0, 0, 1);
+    rig.frames(2);
+
+    for (int frame = 0; frame < 20; frame++) {
+        rig.host(MessageType::SessionVolume, 1, frame * 5, frame + 2);
+        rig.frames(1);
+    }
+    rig.lcd.injectTouch(true, 2 * 81 + 30, 100);
+    rig.frames(2);
+    rig.lcd.injectTouch(false);
+    rig.frames(20);  // The pressed highlight fades out
+    checkBaseline("mixer_strips", rig);
+}
+
+// ScrollView dragged by its background, rows are culled once out of view
+void test_scroll_view() {
+    SceneRig rig;
+    ScrollView* list = new ScrollView(Rectangle(10, 10, 300, 220));
+    rig.gui.addComponent(list);
+    for (int i = 0; i < 10; i++) {
+        list->addChild(new Button(Rectangle(0, i * 50, 250, 40), String("row ") + String(i)));
+    }
+    rig.frames(2);
+
+    for (int y = 200; y >= 40; y -= 8) {
+        rig.lcd.injectTouch(true, 290, y);
+        rig.frames(1);
+    }
+    rig.lcd.injectTouch(false);
+    rig.frames(2);
+    TEST_ASSERT_EQUAL_INT(160, list->getScrollY());
+    checkBaseline("scroll_view", rig);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_mixer);
+    RUN_TEST(test_fader_drag);
+    RUN_TEST(test_meter_storm);
+    RUN_TEST(test_page_switch);
+    RUN_TEST(test_list_scroll);
+    RUN_TEST(test_mixer_strips);
+    RUN_TEST(test_scroll_view);
+    return UNITY_END();
+}
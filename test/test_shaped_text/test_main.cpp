@@ -0,0 +1,189 @@
+// UTF-8 decoding and bidirectional reordering behind ShapedRun (pio test -e
+// native-test). Expected visual order follows the Unicode bidirectional
+// algorithm for one paragraph without embeddings. Drawing a run stays inside
+// the target's clip rect.
+#include <string.h>
+#include <unity.h>
+
+#include "../../src/GUI/ShapedText.hpp"
+#include "LovyanGFX.hpp"
+
+#define ALEF 0x05D0
+#define BET 0x05D1
+#define GIMEL 0x05D2
+
+// One solid 4x4 glyph with an advance of 5
+static const uint8_t blockBitmaps[] = {0x4F};
+static const AtlasGlyph blockGlyphs[] = {{'#', 4, 4, 0, 0, 5, 0}};
+static const AtlasKern blockKerns[] = {{0, 0, 0}};
+static const AtlasFontData blockFont = {4, 4, 1, blockGlyphs, 0, blockKerns, blockBitmaps};
+
+static void assertCodepoints(const uint32_t* expected, int expectedCount, const uint32_t* actual, int count) {
+    TEST_ASSERT_EQUAL_INT(expectedCount, count);
+    for (int i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(expected[i], actual[i], "codepoint differs");
+    }
+}
+
+// Decodes text and puts it in visual order
+static int visual(const char* text, uint32_t* codepoints, bool* rightToLeft) {
+    int count = decodeUtf8(text, codepoints, SHAPED_MAX_CODEPOINTS);
+    *rightToLeft = reorderBidi(codepoints, count);
+    return count;
+}
+
+void test_decode_ascii_and_multibyte() {
+    // "aé€😀": one to four bytes
+    uint32_t codepoints[SHAPED_MAX_CODEPOINTS];
+    int count = decodeUtf8("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", codepoints, SHAPED_MAX_CODEPOINTS);
+    const uint32_t expected[] = {'a', 0x00E9, 0x20AC, 0x1F600};
+    assertCodepoints(expected, 4, codepoints, count);
+}
+
+void test_decode_malformed() {
+    uint32_t codepoints[SHAPED_MAX_CODEPOINTS];
+
+    // Stray continuation byte, then a lead byte cut short by an ASCII letter
+    int count = decodeUtf8("\x80x\xE2\x82y", codepoints, SHAPED_MAX_CODEPOINTS);
+    const uint32_t broken[] = {REPLACEMENT_CHARACTER, 'x', REPLACEMENT_CHARACTER, 'y'};
+    assertCodepoints(broken, 4, codepoints, count);
+
+    // Overlong '/', an encoded surrogate and a value past U+10FFFF
+    count = decodeUtf8("\xC0\xAF\xED\xA0\x80\xF4\x90\x80\x80", codepoints, SHAPED_MAX_CODEPOINTS);
+    const uint32_t invalid[] = {REPLACEMENT_CHARACTER, REPLACEMENT_CHARACTER, REPLACEMENT_CHARACTER};
+    assertCodepoints(invalid, 3, codepoints, count);
+
+    // Truncated at the end of the string
+    count = decodeUtf8("a\xF0\x9F", codepoints, SHAPED_MAX_CODEPOINTS);
+    const uint32_t truncated[] = {'a', REPLACEMENT_CHARACTER};
+    assertCodepoints(truncated, 2, codepoints, count);
+}
+
+void test_decode_drops_marks_and_formatting() {
+    // e + combining acute, zero width joiner, right-to-left mark, byte order mark
+    uint32_t codepoints[SHAPED_MAX_CODEPOINTS];
+    int count = decodeUtf8("e\xCC\x81\xE2\x80\x8D\xE2\x80\x8F\xEF\xBB\xBFz", codepoints, SHAPED_MAX_CODEPOINTS);
+    const uint32_t expected[] = {'e', 'z'};
+    assertCodepoints(expected, 2, codepoints, count);
+}
+
+void test_decode_stops_at_capacity() {
+    uint32_t codepoints[4];
+    TEST_ASSERT_EQUAL_INT(4, decodeUtf8("abcdefgh", codepoints, 4));
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE('d', codepoints[3], "last codepoint kept");
+}
+
+void test_reorder_left_to_right_unchanged() {
+    uint32_t codepoints[SHAPED_MAX_CODEPOINTS];
+    bool rightToLeft;
+    int count = visual("Mix (2) [a]", codepoints, &rightToLeft);
+    const uint32_t expected[] = {'M', 'i', 'x', ' ', '(', '2', ')', ' ', '[', 'a', ']'};
+    TEST_ASSERT_FALSE(rightToLeft);
+    assertCodepoints(expected, 11, codepoints, count);
+}
+
+void test_reorder_right_to_left_with_digits() {
+    // "אב 12 ג": digits keep their order inside the reversed line
+    uint32_t codepoints[SHAPED_MAX_CODEPOINTS];
+    bool rightToLeft;
+    int count = visual("\xD7\x90\xD7\x91 12 \xD7\x92", codepoints, &rightToLeft);
+    const uint32_t expected[] = {GIMEL, ' ', '1', '2', ' ', BET, ALEF};
+    TEST_ASSERT_TRUE(rightToLeft);
+    assertCodepoints(expected, 7, codepoints, count);
+}
+
+void test_reorder_embedded_right_to_left() {
+    // "a אב b": the Hebrew word alone is reversed
+    uint32_t codepoints[SHAPED_MAX_CODEPOINTS];
+    bool rightToLeft;
+    int count = visual("a \xD7\x90\xD7\x91 b", codepoints, &rightToLeft);
+    const uint32_t expected[] = {'a', ' ', BET, ALEF, ' ', 'b'};
+    TEST_ASSERT_FALSE(rightToLeft);
+    assertCodepoints(expected, 6, codepoints, count);
+}
+
+void test_reorder_brackets_pair_around_opposite_text() {
+    // "אב (x) 12": N0 gives both brackets the paragraph direction, so they stay a balanced, mirrored pair
+    uint32_t codepoints[SHAPED_MAX_CODEPOINTS];
+    bool rightToLeft;
+    int count = visual("\xD7\x90\xD7\x91 (x) 12", codepoints, &rightToLeft);
+    const uint32_t expected[] = {'1', '2', ' ', '(', 'x', ')', ' ', BET, ALEF};
+    TEST_ASSERT_TRUE(rightToLeft);
+    assertCodepoints(expected, 9, codepoints, count);
+}
+
+void test_reorder_brackets_follow_context() {
+    // "a (אב) b": the pair holds only right-to-left text but follows a left-to-right letter
+    uint32_t codepoints[SHAPED_MAX_CODEPOINTS];
+    bool rightToLeft;
+    int count = visual("a (\xD7\x90\xD7\x91) b", codepoints, &rightToLeft);
+    const uint32_t expected[] = {'a', ' ', '(', BET, ALEF, ')', ' ', 'b'};
+    TEST_ASSERT_FALSE(rightToLeft);
+    assertCodepoints(expected, 8, codepoints, count);
+
+    // "אב [(x)] y": nested pairs resolve outermost first
+    count = visual("\xD7\x90\xD7\x91 [(x)] y", codepoints, &rightToLeft);
+    const uint32_t nested[] = {'y', ' ', '[', '(', 'x', ')', ']', ' ', BET, ALEF};
+    TEST_ASSERT_TRUE(rightToLeft);
+    assertCodepoints(nested, 10, codepoints, count);
+}
+
+void test_reorder_unpaired_bracket_stays_neutral() {
+    // "אב (x": no closing bracket, the lone one mirrors with the text around it
+    uint32_t codepoints[SHAPED_MAX_CODEPOINTS];
+    bool rightToLeft;
+    int count = visual("\xD7\x90\xD7\x91 (x", codepoints, &rightToLeft);
+    const uint32_t expected[] = {'x', ')', ' ', BET, ALEF};
+    TEST_ASSERT_TRUE(rightToLeft);
+    assertCodepoints(expected, 5, codepoints, count);
+}
+
+void test_shaped_run_visual_text() {
+    ShapedRun run;
+    run.shape("\xD7\x90\xD7\x91 (x) 12", nullptr);
+    TEST_ASSERT_TRUE(run.isRightToLeft());
+    TEST_ASSERT_EQUAL_STRING("12 (x) ??", run.getVisualText());
+}
+
+void test_shaped_run_draw_clipped() {
+    // "###" covers x 10..23 with gaps, the clip cuts the first and last block and the bottom row
+    lgfx::LGFX_Device lcd(40, 20);
+    lcd.fillScreen(TFT_BLACK);
+    ShapedRun run;
+    run.shape("###", &blockFont);
+    lcd.setClipRect(12, 5, 9, 2);
+    run.draw(lcd, blockFont, 10, 4, TFT_WHITE, TFT_BLACK);
+    lcd.clearClipRect();
+
+    for (int y = 0; y < 20; y++) {
+        for (int x = 0; x < 40; x++) {
+            bool inGlyph = x >= 10 && x < 24 && (x - 10) % 5 < 4 && y >= 4 && y < 8;
+            bool inClip = x >= 12 && x < 21 && y >= 5 && y < 7;
+            uint32_t expected = inGlyph && inClip ? TFT_WHITE : TFT_BLACK;
+            TEST_ASSERT_EQUAL_HEX32_MESSAGE(expected, lcd.readPixelValue(x, y), "pixel outside the clip or glyph");
+        }
+    }
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_decode_ascii_and_multibyte);
+    RUN_TEST(test_decode_malformed);
+    RUN_TEST(test_decode_drops_marks_and_formatting);
+    RUN_TEST(test_decode_stops_at_capacity);
+    RUN_TEST(test_reorder_left_to_right_unchanged);
+    RUN_TEST(test_reorder_right_to_left_with_digits);
+    RUN_TEST(test_reorder_embedded_right_to_left);
+    RUN_TEST(test_reorder_brackets_pair_around_opposite_text);
+    RUN_TEST(test_reorder_brackets_follow_context);
+    RUN_TEST(test_reorder_unpaired_bracket_stays_neutral);
+    RUN_TEST(test_shaped_run_visual_text);
+    RUN_TEST(test_shaped_run_draw_clipped);
+    return UNITY_END();
+}
@@ -0,0 +1,244 @@
+// StateStore over RamFlash (pio test -e native-test): records append to the
+// current sector, full sectors compact round robin, a reload after a torn
+// write keeps the last complete state, and erases stay level across sectors.
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+
+#include <algorithm>
+
+#include "../../src/mixer/MixerModel.hpp"
+#include "../../src/mixer/StateStore.hpp"
+#include "../../src/storage/RamFlash.hpp"
+
+#define TEST_SECTORS 4
+
+// RamFlash that can cut a write short, like a reset in the middle of programming
+class TearingFlash : public RamFlash {
+   public:
+    TearingFlash(size_t sectors) : RamFlash(sectors), m_tearOffset(SIZE_MAX), m_tearLength(0) {
+    }
+
+    // The next write starting at offset stores only its first length bytes
+    void tearWriteAt(size_t offset, size_t length) {
+        m_tearOffset = offset;
+        m_tearLength = length;
+    }
+
+    bool write(size_t offset, const void* data, size_t length) override {
+        if (offset == m_tearOffset) {
+            length = std::min(length, m_tearLength);
+            m_tearOffset = SIZE_MAX;
+        }
+        return RamFlash::write(offset, data, length);
+    }
+
+   private:
+    size_t m_tearOffset;
+    size_t m_tearLength;
+};
+
+static MixerSession session(int16_t volume, bool muted, const char* name) {
+    MixerSession state;
+    memset(&state, 0, sizeof(state));
+    state.active = true;
+    state.muted = muted;
+    state.volume = volume;
+    strncpy(state.name, name, MESSAGE_TEXT_LEN - 1);
+    return state;
+}
+
+// Changes one session in the model and lets the store write it once the mixer is still
+static void save(StateStore& store, MixerModel& model, uint8_t index, const MixerSession& state, uint32_t& nowMs) {
+    model.setSession(index, state);
+    store.markDirty(index, FIELD_ALL, nowMs);
+    nowMs += STORE_QUIET_MS;
+    store.update(model, nowMs);
+    store.service();
+}
+
+static void assertSession(const MixerModel& model, uint8_t index, int16_t volume, bool muted, const char* name) {
+    const MixerSession& state = model.getSession(index);
+    TEST_ASSERT_TRUE(state.active);
+    TEST_ASSERT_EQUAL_INT(volume, state.volume);
+    TEST_ASSERT_EQUAL(muted, state.muted);
+    TEST_ASSERT_EQUAL_STRING(name, state.name);
+}
+
+void test_blank_region_loads_nothing() {
+    RamFlash flash(TEST_SECTORS);
+    StateStore store(flash);
+    MixerModel model;
+    TEST_ASSERT_FALSE(store.load(model));
+    TEST_ASSERT_EQUAL_UINT32(TEST_SECTORS, store.getSectorCount());
+    TEST_ASSERT_EQUAL_UINT8(0, model.getSessionCount());
+}
+
+void test_append_and_reload() {
+    RamFlash flash(TEST_SECTORS);
+    uint32_t nowMs = 0;
+    {
+        StateStore store(flash);
+        MixerModel model;
+        store.load(model);
+        save(store, model, 0, session(40, false, "Music"), nowMs);
+        save(store, model, 2, session(75, true, "Game"), nowMs);
+        save(store, model, 0, session(55, false, "Music"), nowMs);
+
+        // The first save starts sector 0 with every active session, later ones append
+        TEST_ASSERT_EQUAL_UINT32(0, store.getSector());
+        TEST_ASSERT_EQUAL_UINT32(1, store.getCompactions());
+        TEST_ASSERT_EQUAL_UINT32(4, store.getUsedSlots());
+        TEST_ASSERT_EQUAL_UINT32(0, store.getErrors());
+    }
+
+    StateStore store(flash);
+    MixerModel model;
+    TEST_ASSERT_TRUE(store.load(model));
+    TEST_ASSERT_EQUAL_UINT8(2, model.getSessionCount());
+    assertSession(model, 0, 55, false, "Music");
+    assertSession(model, 2, 75, true, "Game");
+    TEST_ASSERT_EQUAL_UINT32(4, store.getUsedSlots());
+}
+
+void test_changes_coalesce_until_still() {
+    RamFlash flash(TEST_SECTORS);
+    StateStore store(flash);
+    MixerModel model;
+    store.load(model);
+
+    uint32_t nowMs = 0;
+    for (int16_t volume = 0; volume <= 50; volume += 10) {
+        model.setSession(1, session(volume, false, "Voice"));
+        store.markDirty(1, FIELD_VOLUME, nowMs);
+        nowMs += STORE_QUIET_MS / 2;
+        store.update(model, nowMs);
+        store.service();
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, store.getRecordsWritten());
+
+    store.update(model, nowMs + STORE_QUIET_MS);
+    store.service();
+    TEST_ASSERT_EQUAL_UINT32(1, store.getRecordsWritten());
+}
+
+void test_compaction_wraps_the_ring() {
+    RamFlash flash(TEST_SECTORS);
+    StateStore store(flash);
+    MixerModel model;
+    store.load(model);
+
+    // Enough single-session saves to fill every sector and come back to sector 0
+    uint32_t nowMs = 0;
+    uint32_t saves = (TEST_SECTORS + 1) * STORE_SLOTS_PER_SECTOR;
+    for (uint32_t i = 0; i < saves; i++) {
+        save(store, model, i % 3, session(i % 101, (i & 1) != 0, "Ring"), nowMs);
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(TEST_SECTORS, store.getCompactions());
+    TEST_ASSERT_EQUAL_UINT32(0, store.getErrors());
+
+    StateStore reloaded(flash);
+    MixerModel restored;
+    TEST_ASSERT_TRUE(reloaded.load(restored));
+    TEST_ASSERT_EQUAL_UINT32(store.getSector(), reloaded.getSector());
+    TEST_ASSERT_EQUAL_UINT32(store.getGeneration(), reloaded.getGeneration());
+    for (uint8_t i = 0; i < 3; i++) {
+        const MixerSession& expected = model.getSession(i);
+        assertSession(restored, i, expected.volume, expected.muted, "Ring");
+    }
+}
+
+void test_reload_after_torn_record() {
+    TearingFlash flash(TEST_SECTORS);
+    uint32_t nowMs = 0;
+    uint32_t usedSlots;
+    {
+        StateStore store(flash);
+        MixerModel model;
+        store.load(model);
+        save(store, model, 0, session(30, false, "Chat"), nowMs);
+        save(store, model, 0, session(35, false, "Chat"), nowMs);
+        flash.tearWriteAt(store.getSector() * FLASH_SECTOR_SIZE + store.getUsedSlots() * STORE_SLOT_BYTES, STORE_SLOT_BYTES / 2);
+        save(store, model, 0, session(90, true, "Chat"), nowMs);
+        usedSlots = store.getUsedSlots();
+    }
+
+    // The half-written record fails its CRC, the one before it stands
+    StateStore store(flash);
+    MixerModel model;
+    TEST_ASSERT_TRUE(store.load(model));
+    assertSession(model, 0, 35, false, "Chat");
+
+    // Appends continue after the torn slot instead of writing over it
+    TEST_ASSERT_EQUAL_UINT32(usedSlots, store.getUsedSlots());
+    save(store, model, 0, session(60, false, "Chat"), nowMs);
+    StateStore reloaded(flash);
+    MixerModel restored;
+    TEST_ASSERT_TRUE(reloaded.load(restored));
+    assertSession(restored, 0, 60, false, "Chat");
+}
+
+void test_reload_after_torn_compaction() {
+    TearingFlash flash(TEST_SECTORS);
+    StateStore store(flash);
+    MixerModel model;
+    store.load(model);
+
+    uint32_t nowMs = 0;
+    save(store, model, 0, session(20, false, "Keep"), nowMs);
+    while (store.getUsedSlots() < STORE_SLOTS_PER_SECTOR) {
+        save(store, model, 0, session(20, false, "Keep"), nowMs);
+    }
+    uint32_t sector = store.getSector();
+
+    // Compaction writes the session, then the header, which the reset cuts short
+    uint32_t next = (sector + 1) % TEST_SECTORS;
+    flash.tearWriteAt(next * FLASH_SECTOR_SIZE, 6);  // Magic and half the generation, no CRC
+    save(store, model, 0, session(80, false, "Lost"), nowMs);
+    TEST_ASSERT_EQUAL_UINT32(next, store.getSector());
+
+    // The new sector has no valid header, the old one is still complete
+    StateStore reloaded(flash);
+    MixerModel restored;
+    TEST_ASSERT_TRUE(reloaded.load(restored));
+    TEST_ASSERT_EQUAL_UINT32(sector, reloaded.getSector());
+    assertSession(restored, 0, 20, false, "Keep");
+}
+
+void test_erases_stay_level() {
+    RamFlash flash(TEST_SECTORS);
+    StateStore store(flash);
+    MixerModel model;
+    store.load(model);
+
+    uint32_t nowMs = 0;
+    for (uint32_t i = 0; i < 10 * TEST_SECTORS * STORE_SLOTS_PER_SECTOR; i++) {
+        save(store, model, i % MAX_SESSIONS, session(i % 101, false, "Wear"), nowMs);
+    }
+
+    uint32_t fewest = flash.getEraseCount(0), most = fewest;
+    for (size_t sector = 1; sector < TEST_SECTORS; sector++) {
+        fewest = std::min(fewest, flash.getEraseCount(sector));
+        most = std::max(most, flash.getEraseCount(sector));
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(0, fewest);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, most - fewest);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_blank_region_loads_nothing);
+    RUN_TEST(test_append_and_reload);
+    RUN_TEST(test_changes_coalesce_until_still);
+    RUN_TEST(test_compaction_wraps_the_ring);
+    RUN_TEST(test_reload_after_torn_record);
+    RUN_TEST(test_reload_after_torn_compaction);
+    RUN_TEST(test_erases_stay_level);
+    return UNITY_END();
+}
@@ -0,0 +1,47 @@
+# PlatformIO extra script: regenerates glyph atlases listed in fonts/fonts.txt.
+# Runs before every build (only rebuilding stale headers) and as `pio run -t fonts`.
+Import("env")
+
+import os
+import subprocess
+
+PROJECT_DIR = env.subst("$PROJECT_DIR")
+SPEC = os.path.join(PROJECT_DIR, "fonts", "fonts.txt")
+OUTPUT_DIR = os.path.join(PROJECT_DIR, "src", "GUI", "fonts")
+CONVERTER = os.path.join(PROJECT_DIR, "tools", "fontconv.py")
+
+
+def read_spec():
+    entries = []
+    if not os.path.exists(SPEC):
+        return entries
+    with open(SPEC) as f:
+        for line in f:
+            line = line.split("#", 1)[0].strip()
+            if line:
+                font, size, name, *chars = line.split()
+                entries.append((os.path.join(PROJECT_DIR, "fonts", font), size, name, chars[0] if chars else "0x20-0x7E"))
+    return entries
+
+
+def build_fonts(force=False):
+    os.makedirs(OUTPUT_DIR, exist_ok=True)
+    for font, size, name, chars in read_spec():
+        output = os.path.join(OUTPUT_DIR, name + ".h")
+        if not os.path.exists(font):
+            print("fonts: %s not found, skipping %s" % (font, name))
+            continue
+        if not force and os.path.exists(output) and os.path.getmtime(output) >= max(os.path.getmtime(font), os.path.getmtime(SPEC)):
+            continue
+        subprocess.check_call([env.subst("$PYTHONEXE"), CONVERTER, font, size, name, output, "--chars", chars])
+
+
+build_fonts()
+
+env.AddCustomTarget(
+    name="fonts",
+    dependencies=None,
+    actions=[lambda *args, **kwargs: build_fonts(force=True)],
+    title="Build fonts",
+    description="Convert fonts/fonts.txt entries into glyph atlas headers",
+)
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""Convert a TTF/OTF font into an anti-aliased glyph atlas header for AtlasFont.
+
+Usage: fontconv.py FONT SIZE NAME OUTPUT [--chars FIRST-LAST[,FIRST-LAST...]] [--binary]
+
+Glyph coverage is quantized to 4 bits and run-length coded as documented in
+src/GUI/AtlasFont.hpp. Kerning pairs are taken from the font's kern table.
+With --binary the atlas is written as a font file for the SD card, in the
+layout read by src/assets/FontFile.hpp, instead of a header.
+Requires freetype-py (pip install freetype-py).
+"""
+
+import argparse
+import struct
+import sys
+
+import freetype
+
+
+def parse_ranges(spec):
+    codepoints = []
+    for part in spec.split(","):
+        first, _, last = part.partition("-")
+        first = int(first, 0)
+        last = int(last, 0) if last else first
+        codepoints.extend(range(first, last + 1))
+    return sorted(set(codepoints))
+
+
+def encode_runs(alphas):
+    """RLE: 0x00 transparent run, 0x40 solid run, 0x80 literal run (packed nibbles)."""
+    out = bytearray()
+    i = 0
+    while i < len(alphas):
+        value = alphas[i]
+        if value in (0, 15):
+            run = 1
+            while i + run < len(alphas) and alphas[i + run] == value and run < 64:
+                run += 1
+            out.append((0x00 if value == 0 else 0x40) | (run - 1))
+            i += run
+            continue
+
+        # Literal run until the next stretch of two or more solid/transparent pixels
+        start = i
+        while i < len(alphas) and i - start < 64:
+            if alphas[i] in (0, 15) and i + 1 < len(alphas) and alphas[i + 1] == alphas[i]:
+                break
+            i += 1
+        literals = alphas[start:i]
+        out.append(0x80 | (len(literals) - 1))
+        for j in range(0, len(literals), 2):
+            high = literals[j]
+            low = literals[j + 1] if j + 1 < len(literals) else 0
+            out.append((high << 4) | low)
+    return out
+
+
+def convert(font_path, size, name, codepoints):
+    face = freetype.Face(font_path)
+    face.set_pixel_sizes(0, size)
+    ascent = face.size.ascender >> 6
+    line_height = face.size.height >> 6
+
+    glyphs = []
+    bitmaps = bytearray()
+    for codepoint in codepoints:
+        if face.get_char_index(codepoint) == 0:
+            continue
+        face.load_char(chr(codepoint), freetype.FT_LOAD_RENDER | freetype.FT_LOAD_TARGET_NORMAL)
+        glyph = face.glyph
+        bitmap = glyph.bitmap
+
+        alphas = []
+        for row in range(bitmap.rows):
+            for column in range(bitmap.width):
+                alphas.append(bitmap.buffer[row * bitmap.pitch + column] >> 4)
+
+        glyphs.append({
+            "codepoint": codepoint,
+            "width": bitmap.width,
+            "height": bitmap.rows,
+            "x_offset": glyph.bitmap_left,
+            "y_offset": ascent - glyph.bitmap_top,
+            "advance": glyph.advance.x >> 6,
+            "offset": len(bitmaps),
+        })
+        bitmaps += encode_runs(alphas)
+
+    kerns = []
+    if face.has_kerning:
+        for left in glyphs:
+            left_index = face.get_char_index(left["codepoint"])
+            for right in glyphs:
+                vector = face.get_kerning(left_index, face.get_char_index(right["codepoint"]))
+                adjust = vector.x >> 6
+                if adjust != 0:
+                    kerns.append((left["codepoint"], right["codepoint"], max(-128, min(127, adjust))))
+
+    return ascent, line_height, glyphs, kerns, bitmaps
+
+
+def write_header(path, name, source, size, ascent, line_height, glyphs, kerns, bitmaps):
+    lines = [
+        "// Generated by tools/fontconv.py from %s at %dpx, do not edit" % (source, size),
+        "#pragma once",
+        '#include "../AtlasFont.hpp"',
+        "",
+        "static const uint8_t %s_bitmaps[] PROGMEM = {" % name,
+    ]
+    for i in range(0, len(bitmaps), 16):
+        lines.append("    " + ", ".join("0x%02X" % b for b in bitmaps[i:i + 16]) + ",")
+    lines.append("};")
+    lines.append("")
+    lines.append("static const AtlasGlyph %s_glyphs[] PROGMEM = {" % name)
+    for g in glyphs:
+        lines.append("    {0x%04X, %d, %d, %d, %d, %d, %d}," % (
+            g["codepoint"], g["width"], g["height"], g["x_offset"], g["y_offset"], g["advance"], g["offset"]))
+    lines.append("};")
+    lines.append("")
+    lines.append("static const AtlasKern %s_kerns[] PROGMEM = {" % name)
+    for left, right, adjust in kerns:
+        lines.append("    {0x%04X, 0x%04X, %d}," % (left, right, adjust))
+    if not kerns:
+        lines.append("    {0, 0, 0},")
+    lines.append("};")
+    lines.append("")
+    lines.append("static const AtlasFontData %s = {%d, %d, %d, %s_glyphs, %d, %s_kerns, %s_bitmaps};" % (
+        name, line_height, ascent, len(glyphs), name, len(kerns), name, name))
+    lines.append("")
+
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def write_binary(path, ascent, line_height, glyphs, kerns, bitmaps):
+    data = bytearray(struct.pack("<IBBHHI", 0x31464D55, line_height, ascent, len(glyphs), len(kerns), len(bitmaps)))
+    for g in glyphs:
+        data += struct.pack("<HBBbbBI", g["codepoint"], g["width"], g["height"], g["x_offset"], g["y_offset"], g["advance"], g["offset"])
+    for left, right, adjust in kerns:
+        data += struct.pack("<HHb", left, right, adjust)
+    data += bitmaps
+
+    with open(path, "wb") as f:
+        f.write(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("font")
+    parser.add_argument("size", type=int)
+    parser.add_argument("name")
+    parser.add_argument("output")
+    parser.add_argument("--chars", default="0x20-0x7E")
+    parser.add_argument("--binary", action="store_true", help="write an SD card font file instead of a header")
+    args = parser.parse_args()
+
+    ascent, line_height, glyphs, kerns, bitmaps = convert(args.font, args.size, args.name, parse_ranges(args.chars))
+    if args.binary:
+        write_binary(args.output, ascent, line_height, glyphs, kerns, bitmaps)
+    else:
+        write_header(args.output, args.name, args.font.split("/")[-1], args.size, ascent, line_height, glyphs, kerns, bitmaps)
+    print("%s: %d glyphs, %d kerning pairs, %d bitmap bytes" % (args.output, len(glyphs), len(kerns), len(bitmaps)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Reconstruct the device screen from its mirror stream (src/mirror/MirrorFormat.hpp).
+
+Usage: mirror_view.py PORT [--baud 115200] [--out screen.ppm] [--once] [--show]
+
+Sends the "mirror" console command, then rebuilds the screen from the frames
+the device sends. Every complete update (a Flush) is written to --out as a
+PPM image; --once stops after the first one, which makes a screenshot, and
+--show displays the screen live in a window. Log lines and console replies
+arriving meanwhile are printed. The port carries the mixer protocol too, so
+the host mixer application must not hold it meanwhile.
+Requires pyserial (pip install pyserial).
+"""
+
+import argparse
+import sys
+
+import serial
+
+SERIAL_FRAME_SYNC = 0xA5
+MIRROR_FRAME_TAG = 0xF0
+TEXT_FRAME_TAG = 0xF1
+OP_HELLO, OP_PALETTE, OP_TILE, OP_FLUSH = 1, 2, 3, 4
+
+
+def read_frames(port):
+    """Yields frame payloads: SYNC, length, payload, 8-bit checksum (src/comm/SerialTransport.hpp)."""
+    while True:
+        byte = port.read(1)
+        if not byte or byte[0] != SERIAL_FRAME_SYNC:
+            continue
+        length = port.read(1)
+        if not length or length[0] == 0:
+            continue
+        payload = port.read(length[0])
+        checksum = port.read(1)
+        if len(payload) == length[0] and checksum and sum(payload) & 0xFF == checksum[0]:
+            yield payload
+
+
+def rgb888(color):
+    r, g, b = color >> 11, (color >> 5) & 0x3F, color & 0x1F
+    return bytes(((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)))
+
+
+class Screen:
+    def __init__(self):
+        self.width = self.height = 0
+        self.tile = 16
+        self.indices = bytearray()
+        self.palette = [rgb888(0)] * 16
+
+    def apply(self, frame):
+        """Applies one mirror frame, returns True on a Flush."""
+        op = frame[1]
+        if op == OP_HELLO:
+            self.width = frame[2] | frame[3] << 8
+            self.height = frame[4] | frame[5] << 8
+            self.tile = frame[6]
+            self.indices = bytearray(self.width * self.height)
+        elif op == OP_PALETTE:
+            first, count = frame[2], frame[3]
+            for i in range(count):
+                self.palette[first + i] = rgb888(frame[4 + i * 2] | frame[5 + i * 2] << 8)
+        elif op == OP_TILE and self.width:
+            column, row, pixel = frame[2], frame[3], frame[4]
+            tile_width = min(self.tile, self.width - column * self.tile)
+            for run in frame[5:]:
+                for _ in range((run >> 4) + 1):
+                    x = column * self.tile + pixel % tile_width
+                    y = row * self.tile + pixel // tile_width
+                    self.indices[y * self.width + x] = run & 0x0F
+                    pixel += 1
+        elif op == OP_FLUSH:
+            return True
+        return False
+
+    def ppm(self):
+        header = b"P6 %d %d 255\n" % (self.width, self.height)
+        return header + b"".join(self.palette[index] for index in self.indices)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--out", default="screen.ppm")
+    parser.add_argument("--once", action="store_true")
+    parser.add_argument("--show", action="store_true")
+    args = parser.parse_args()
+
+    window = None
+    if args.show:
+        import tkinter
+
+        window = tkinter.Tk()
+        window.title("unimix mirror")
+        label = tkinter.Label(window)
+        label.pack()
+
+    screen = Screen()
+    with serial.Serial(args.port, args.baud, timeout=1) as port:
+        port.write(b"mirror\n")
+        try:
+            for frame in read_frames(port):
+                if frame[0] == TEXT_FRAME_TAG:
+                    sys.stdout.write(frame[1:].decode("utf-8", "replace"))
+                    continue
+                if frame[0] != MIRROR_FRAME_TAG or not screen.apply(frame):
+                    continue  # Mixer protocol traffic, or an update still arriving
+                image = screen.ppm()
+                with open(args.out, "wb") as f:
+                    f.write(image)
+                if window is not None:
+                    photo = tkinter.PhotoImage(data=image, format="PPM")
+                    label.configure(image=photo)
+                    label.image = photo
+                    window.update()
+                if args.once:
+                    print("%s: %dx%d" % (args.out, screen.width, screen.height))
+                    break
+        except KeyboardInterrupt:
+            pass
+        finally:
+            port.write(b"mirror-off\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())